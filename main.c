@@ -1,25 +1,28 @@
 #include "nrf_pwr_mgmt.h"
 
 #include "app_timer.h"
+#include "app_util_platform.h"
 #include "nrf_drv_clock.h"
 
 #include "log.h"
 #include "init.h"
 #include "Si7021.h"
+#include "sampler.h"
 #include "bluetooth.h"
 #include "display.h"
 
 
 
-APP_TIMER_DEF(m_sensor_timer);
-
+// Written by sensor_done from the TWIM interrupt, only copy it out with the interrupts off
 static volatile unsigned int reading = 0;
-static void sensor_timer_handler(void * p_context) {
-    // We cannot read the sensor from here, I suspect this is because
-    // this handler is called from an interrupt and the I2C also uses
-    // interrupts at the same (or lower) priority.
-    // This could thus be fixed by changing the priorities, but I'd
-    // rather not read the I2C from an interrupt anyway
+static volatile temperature_sensor_data_t sensor_values_inside;
+
+static void sensor_done(const temperature_sensor_data_t * const data, void * context) {
+    // Keep showing the last reading, the next sample tries again
+    if(data == NULL)
+        return;
+
+    sensor_values_inside = *data;
     reading = 1;
 }
 
@@ -32,36 +35,42 @@ static inline void idle_state_handle(void) {
 
 
 int main(void) {
-    ret_code_t err_code;
-    temperature_sensor_data_t sensor_values_inside, sensor_values_outside;
+    temperature_sensor_data_t sensor_values_inside_copy;
+    temperature_sensor_data_t sensor_values_outside;
 
     // Initialize all modules
     init();
 
-    // Create timer
-    err_code = app_timer_create(&m_sensor_timer,
-                                APP_TIMER_MODE_REPEATED,
-                                sensor_timer_handler);
-    APP_ERROR_CHECK(err_code);
-
-    // Start timer
-    err_code = app_timer_start(m_sensor_timer, APP_TIMER_TICKS(1000), NULL);
-    APP_ERROR_CHECK(err_code);
+    // Sample fast while the readings change and slow when they are stable,
+    // the callback tells us when there is something new
+    sampler_start(&sampler_policy_adaptive, sensor_done, NULL);
 
     // Enter main loop.
     while(true) {
-        idle_state_handle();
+        // Only sleep when the display has nothing left to draw
+        if(display_process())
+            log_flush();
+        else
+            idle_state_handle();
 
         if(reading == 1) {
-            sensor_values_inside = temperature_sensor_read();
+            // A reading that arrives after this is kept for the next pass
+            CRITICAL_REGION_ENTER();
+            sensor_values_inside_copy = sensor_values_inside;
+            reading = 0;
+            CRITICAL_REGION_EXIT();
+
             sensor_values_outside = bluetooth_get_outside_temperature();
 
-            NRF_LOG_INFO("Temp inside: %i outside: %i", sensor_values_inside.temperature, sensor_values_outside.temperature);
-            NRF_LOG_INFO("Humidity inside: %i outside: %i", sensor_values_inside.humidity, sensor_values_outside.humidity);
+            NRF_LOG_INFO("Temp inside: " SENSOR_VALUE_MARKER " outside: " SENSOR_VALUE_MARKER,
+                         SENSOR_VALUE(sensor_values_inside_copy.temperature), SENSOR_VALUE(sensor_values_outside.temperature));
+            NRF_LOG_INFO("Humidity inside: " SENSOR_VALUE_MARKER " outside: " SENSOR_VALUE_MARKER,
+                         SENSOR_VALUE(sensor_values_inside_copy.humidity), SENSOR_VALUE(sensor_values_outside.humidity));
 
-            display_set_sensor_data(&sensor_values_inside, &sensor_values_outside);
+            display_set_sensor_data(&sensor_values_inside_copy, &sensor_values_outside);
 
-            reading = 0;
+            // Can restart the sampling at other settings
+            sampler_update(&sensor_values_inside_copy);
         }
     }
 }
@@ -1,10 +1,14 @@
 #include "Si7021.h"
 
 #include "app_error.h"
-#include "nrfx_twi.h"
+#include "nrfx_twim.h"
+#include "nrfx_rtc.h"
+#include "nrfx_ppi.h"
 #include "nrf_delay.h"
+#include "app_timer.h"
 #include <nrf_assert.h>
 #include "log.h"
+#include "perf.h"
 
 // Device specific commands
 static const uint8_t power_up_time_ms = 15;
@@ -13,45 +17,145 @@ static const uint8_t RST_CMD = 0xFE;
 // static const uint8_t MSR_TMP_CMD = 0xE3;
 static const uint8_t GET_TMP_CMD = 0xE0;
 static const uint8_t MSR_HUM_CMD = 0xE5;
+static const uint8_t MSR_HUM_NOHOLD_CMD = 0xF5;
 static const uint8_t USR_REG = 0xE7;
 static const uint8_t USR_RES0 = 0;
 static const uint8_t USR_RES1 = 7;
 
-static const nrfx_twi_t instance = NRFX_TWI_INSTANCE(0);    // Create an TWI instance using register 0
+// The sensor doesn't acknowledge a read while it is still converting, try again after this
+#define RETRY_TIME_MS       2
+// After this many retries in one measurement the sensor is taken as missing or stuck, and the measurement fails
+#define MAX_RETRIES         10
+
+// Hardware sampling, in ticks of the RTC from the start of a sample.
+// The no-hold humidity command is sent at the start, the bus is idle during the conversion.
+// After the conversion the humidity is read, then the temperature of that conversion is asked and read,
+// one RTC compare per transfer. The CPU wakes up with the last one
+#define SAMPLE_RTC_FREQUENCY    1024
+#define SAMPLE_NUM_TRANSFERS    4
+#define SAMPLE_READ_MARGIN      4
+// Between the transfers after the conversion, a transfer of 2 bytes takes well under a tick
+#define SAMPLE_STEP_TICKS       1
+// Longest wait for the last read, before giving up on the sample
+#define SAMPLE_WAIT_US          500
+
+// Steps of an asynchronous measurement, the state is the transfer that is (about to be) on the bus
+typedef enum {
+    MEASURE_IDLE,
+    MEASURE_START,          // Send the no-hold humidity command
+    MEASURE_HUMIDITY,       // Read the humidity, after the conversion time
+    MEASURE_TEMPERATURE,    // Read the temperature that was measured with it
+    MEASURE_SAMPLING,       // The hardware is sampling, the TWIM is not ours
+} measure_state_t;
+
+static const nrfx_twim_t instance = NRFX_TWIM_INSTANCE(0);  // Create an TWIM instance using register 0
 static volatile unsigned int transfer_done = 0;
 
+// EasyDMA can only read RAM, so the commands (in flash) are copied here before sending them
+static uint8_t tx_buffer[2];
+
+// Indexed by temperature_sensor_resolution_t
+static const temperature_sensor_timing_t timings[TEMPERATURE_SENSOR_NUM_RES] = {
+    { .humidity_us = 12000, .temperature_us = 10800 },
+    { .humidity_us = 3100,  .temperature_us = 3800 },
+    { .humidity_us = 4500,  .temperature_us = 6200 },
+    { .humidity_us = 7000,  .temperature_us = 2400 },
+};
+
+static temperature_sensor_resolution_t resolution = TEMPERATURE_SENSOR_RES_RH12_T14;
+
+APP_TIMER_DEF(measure_timer);
+static volatile measure_state_t measure_state = MEASURE_IDLE;
+static temperature_sensor_callback_t measure_callback;
+static void * measure_context;
+static temperature_sensor_data_t measure_data;
+static uint8_t measure_rx[2];
+static uint8_t measure_retries;
+// Time the measurement started (perf_ticks) and the cycles the CPU spent on it
+static uint32_t measure_ticks;
+static uint32_t measure_cycles;
+static uint32_t measure_entry_cycles;
+
+#if SI7021_HARDWARE_SAMPLING
+static const nrfx_rtc_t sample_rtc = NRFX_RTC_INSTANCE(2);
+// RTC COMPARE0 (the period) -> STARTTX of the humidity command, forked to clear the RTC.
+// COMPARE1 -> STARTRX of the humidity, COMPARE2 -> STARTTX of the temperature command,
+// COMPARE3 -> STARTRX of the temperature
+static nrf_ppi_channel_t sample_channels[SAMPLE_NUM_TRANSFERS];
+static temperature_sensor_callback_t sample_callback;
+static void * sample_context;
+static volatile uint32_t sample_errors;
+// Depends on the resolution, set when sampling starts
+static uint32_t sample_done_ticks;
+
+// The TWIM moves to the next command and result after every transfer
+static uint8_t sample_tx[2];
+static uint8_t sample_rx[4];
+#endif
+
 static inline void wait_for_transfer();
-static void twi_handler(nrfx_twi_evt_t const * p_event, void * p_context);
+static void twi_handler(nrfx_twim_evt_t const * p_event, void * p_context);
 static inline void read_bytes(const uint8_t * const tx, const size_t tx_len, uint8_t * rx, const size_t rx_len);
 static inline uint8_t read_register(const uint8_t reg);
 static inline void reset();
 static inline void write_byte(const uint8_t reg, const uint8_t data);
 static inline void apply_settings();
-static inline float tmp_code_to_float(const uint16_t code);
+static inline uint32_t conversion_time_ms();
+static inline int16_t tmp_code_to_centi(const uint16_t code);
+static inline int16_t hum_code_to_centi(const uint16_t code);
+static void measure_step();
+static void measure_done(const bool acknowledged);
+static void measure_timer_handler(void * p_context);
+static inline void measure_enter();
+static inline void measure_count();
+#if SI7021_HARDWARE_SAMPLING
+static void sample_init();
+static void sample_arm();
+static bool sample_wait_for_read();
+static void sample_handler(nrfx_rtc_int_type_t int_type);
+#endif
 
 
 static inline void wait_for_transfer() {
+    // The transfer is a single interrupt, sleep until it is there
     while(transfer_done == 0) {
-        // Maybe go to sleep here?
+        __WFE();
     }
 
     transfer_done = 0;
 }
 
-static void twi_handler(nrfx_twi_evt_t const * p_event, void * p_context) {
-    nrfx_twi_0_irq_handler();
+static void twi_handler(nrfx_twim_evt_t const * p_event, void * p_context) {
+#if SI7021_HARDWARE_SAMPLING
+    // Only errors have an interrupt while sampling
+    if(measure_state == MEASURE_SAMPLING) {
+        sample_errors++;
+        return;
+    }
+#endif
+
+    if(measure_state != MEASURE_IDLE) {
+        measure_enter();
+        measure_done(p_event->type == NRFX_TWIM_EVT_DONE);
+        measure_count();
+        return;
+    }
+
     transfer_done = 1;
 }
 
 static inline void read_bytes(const uint8_t * const tx, const size_t tx_len, uint8_t * rx, const size_t rx_len) {
     nrfx_err_t res;
-    const nrfx_twi_xfer_desc_t desc = NRFX_TWI_XFER_DESC_TXRX(address, (uint8_t*)tx, tx_len, rx, rx_len);
+    const nrfx_twim_xfer_desc_t desc = NRFX_TWIM_XFER_DESC_TXRX(address, tx_buffer, tx_len, rx, rx_len);
+
+    NRFX_ASSERT(tx_len <= sizeof(tx_buffer));
 
     // Clear the rx array
     memset(rx, 0x00, rx_len);
+    memcpy(tx_buffer, tx, tx_len);
 
-    // Send the read command
-    res = nrfx_twi_xfer(&instance, &desc, 0);
+    // Send the read command, the TWIM continues with the read by itself
+    res = nrfx_twim_xfer(&instance, &desc, 0);
     APP_ERROR_CHECK(res);
     wait_for_transfer();
 }
@@ -72,10 +176,13 @@ static inline void reset() {
 static inline void write_byte(const uint8_t reg, const uint8_t data) {
     nrfx_err_t res;
     uint8_t value;
-    const nrfx_twi_xfer_desc_t desc = NRFX_TWI_XFER_DESC_TXTX(address, (uint8_t*)&reg, 1, (uint8_t*)&data, 1);
+    const nrfx_twim_xfer_desc_t desc = NRFX_TWIM_XFER_DESC_TX(address, tx_buffer, 2);
+
+    tx_buffer[0] = reg;
+    tx_buffer[1] = data;
 
     // Write to the register
-    res = nrfx_twi_xfer(&instance, &desc, 0);
+    res = nrfx_twim_xfer(&instance, &desc, 0);
     APP_ERROR_CHECK(res);
     wait_for_transfer();
 
@@ -90,8 +197,9 @@ static inline void apply_settings() {
     // Read the current register value
     reg = read_register(USR_REG);
 
-    // Set the resolution to 00 (max)
+    // The resolution is split over bit 7 and bit 0
     reg &= ~((1<<USR_RES0) | (1<<USR_RES1));
+    reg |= ((resolution >> 1) << USR_RES1) | ((resolution & 0x1) << USR_RES0);
 
     // Write the new register value
     write_byte(USR_REG, reg);
@@ -101,18 +209,27 @@ void temperature_sensor_init() {
     nrfx_err_t res;
 
     // Set the configuration to 400KHz, default config
-    const nrfx_twi_config_t config = {                                                \
-        .frequency          = NRF_TWI_FREQ_400K,                                      \
+    const nrfx_twim_config_t config = {                                               \
+        .frequency          = NRF_TWIM_FREQ_400K,                                     \
         .scl                = 12,                                                     \
         .sda                = 11,                                                     \
-        .interrupt_priority = NRFX_TWI_DEFAULT_CONFIG_IRQ_PRIORITY,                   \
-        .hold_bus_uninit    = NRFX_TWI_DEFAULT_CONFIG_HOLD_BUS_UNINIT,                \
+        .interrupt_priority = NRFX_TWIM_DEFAULT_CONFIG_IRQ_PRIORITY,                  \
+        .hold_bus_uninit    = NRFX_TWIM_DEFAULT_CONFIG_HOLD_BUS_UNINIT,               \
     };
 
-    res = nrfx_twi_init(&instance, &config, twi_handler, NULL);
+    perf_init();
+
+    res = nrfx_twim_init(&instance, &config, twi_handler, NULL);
     APP_ERROR_CHECK(res);
 
-    nrfx_twi_enable(&instance);
+    res = app_timer_create(&measure_timer, APP_TIMER_MODE_SINGLE_SHOT, measure_timer_handler);
+    APP_ERROR_CHECK(res);
+
+    nrfx_twim_enable(&instance);
+
+#if SI7021_HARDWARE_SAMPLING
+    sample_init();
+#endif
 
     reset();
 
@@ -120,30 +237,359 @@ void temperature_sensor_init() {
 }
 
 
-static inline float tmp_code_to_float(const uint16_t code) {
-    // from datasheet
-    return ((175.72f * code)/65536) - 46.85f;
+// From the datasheet: T = 175.72 * code / 65536 - 46.85
+// In hundredths, rounded. 17572 * 65535 still fits in 32 bits
+static inline int16_t tmp_code_to_centi(const uint16_t code) {
+    return (int16_t)((int32_t)((17572 * (uint32_t)code + 32768) >> 16) - 4685);
 }
 
-static inline float hum_code_to_float(const uint16_t code) {
-    // from datasheet
-    return ((125.0f * code)/65536) - 6.0f;
+// From the datasheet: RH = 125 * code / 65536 - 6
+// The sensor can report a little below 0 or above 100%, the datasheet says to clip those
+static inline int16_t hum_code_to_centi(const uint16_t code) {
+    const int32_t value = (int32_t)((12500 * (uint32_t)code + 32768) >> 16) - 600;
+
+    return value < 0 ? 0 : value > 10000 ? 10000 : (int16_t)value;
 }
 
 
 temperature_sensor_data_t temperature_sensor_read() {
+    NRFX_ASSERT(measure_state == MEASURE_IDLE);
+
     const size_t reading_num_bytes = 2;
     uint8_t rx[reading_num_bytes];
     temperature_sensor_data_t data;
+    const uint32_t start_ticks = perf_ticks();
+    const uint32_t start_cycles = perf_cycles();
 
     read_bytes(&MSR_HUM_CMD, 1, rx, reading_num_bytes);
-    data.humidity = hum_code_to_float(rx[0]<<8 | rx[1]);
+    data.humidity = hum_code_to_centi(rx[0]<<8 | rx[1]);
 
     read_bytes(&GET_TMP_CMD, 1, rx, reading_num_bytes);
-    data.temperature = tmp_code_to_float(rx[0]<<8 | rx[1]);
+    data.temperature = tmp_code_to_centi(rx[0]<<8 | rx[1]);
 
-    // NRF_LOG_INFO("Temperature: %i", data.temperature*10);
-    // NRF_LOG_INFO("Humidity: %i", data.humidity*10);
+    // The cycle counter stops while we sleep, so this is the time the CPU was awake
+    NRF_LOG_INFO("Si7021 blocking reading: %u us, CPU awake %u us",
+                 perf_ticks_to_us(start_ticks, perf_ticks()), perf_cycles_to_us(perf_cycles() - start_cycles));
 
     return data;
 }
+
+
+void temperature_sensor_read_async(const temperature_sensor_callback_t callback, void * const context) {
+    NRFX_ASSERT(callback != NULL);
+    NRFX_ASSERT(measure_state == MEASURE_IDLE);
+
+    measure_callback = callback;
+    measure_context = context;
+    measure_retries = 0;
+    measure_state = MEASURE_START;
+    measure_ticks = perf_ticks();
+    measure_cycles = 0;
+
+    measure_enter();
+    measure_step();
+    measure_count();
+}
+
+
+bool temperature_sensor_busy() {
+    return measure_state != MEASURE_IDLE;
+}
+
+
+void temperature_sensor_set_resolution(const temperature_sensor_resolution_t new_resolution) {
+    NRFX_ASSERT(new_resolution < TEMPERATURE_SENSOR_NUM_RES);
+    NRFX_ASSERT(measure_state == MEASURE_IDLE);
+
+    resolution = new_resolution;
+    apply_settings();
+}
+
+
+temperature_sensor_resolution_t temperature_sensor_get_resolution() {
+    return resolution;
+}
+
+
+const temperature_sensor_timing_t * temperature_sensor_get_timing(const temperature_sensor_resolution_t res) {
+    NRFX_ASSERT(res < TEMPERATURE_SENSOR_NUM_RES);
+
+    return &timings[res];
+}
+
+
+// Time of a humidity measurement and the temperature measured with it, at the current resolution
+static inline uint32_t conversion_time_ms() {
+    return (timings[resolution].humidity_us + timings[resolution].temperature_us + 999) / 1000;
+}
+
+
+// Put the transfer of the current state on the bus, the TWI interrupt continues from there
+static void measure_step() {
+    nrfx_err_t res;
+    nrfx_twim_xfer_desc_t desc;
+
+    switch(measure_state) {
+    case MEASURE_START:
+        tx_buffer[0] = MSR_HUM_NOHOLD_CMD;
+        desc = (nrfx_twim_xfer_desc_t)NRFX_TWIM_XFER_DESC_TX(address, tx_buffer, 1);
+        break;
+
+    case MEASURE_HUMIDITY:
+        desc = (nrfx_twim_xfer_desc_t)NRFX_TWIM_XFER_DESC_RX(address, measure_rx, sizeof(measure_rx));
+        break;
+
+    case MEASURE_TEMPERATURE:
+        tx_buffer[0] = GET_TMP_CMD;
+        desc = (nrfx_twim_xfer_desc_t)NRFX_TWIM_XFER_DESC_TXRX(address, tx_buffer, 1, measure_rx, sizeof(measure_rx));
+        break;
+
+    default:
+        NRFX_ASSERT(0);
+        return;
+    }
+
+    res = nrfx_twim_xfer(&instance, &desc, 0);
+    APP_ERROR_CHECK(res);
+}
+
+
+// Called from the TWI interrupt when the transfer of the current state is done
+static void measure_done(const bool acknowledged) {
+    ret_code_t err;
+
+    // Still converting, or the bus had a hiccup. Try the same step again in a bit
+    if(!acknowledged) {
+        if(measure_retries >= MAX_RETRIES) {
+            NRF_LOG_INFO("Si7021 reading failed after %u retries", measure_retries);
+
+            // Idle before the callback, so it can start the next measurement
+            measure_state = MEASURE_IDLE;
+
+            measure_callback(NULL, measure_context);
+            return;
+        }
+
+        measure_retries++;
+        err = app_timer_start(measure_timer, APP_TIMER_TICKS(RETRY_TIME_MS), NULL);
+        APP_ERROR_CHECK(err);
+        return;
+    }
+
+    switch(measure_state) {
+    case MEASURE_START:
+        // The bus is free during the conversion, come back when it should be done
+        measure_state = MEASURE_HUMIDITY;
+        err = app_timer_start(measure_timer, APP_TIMER_TICKS(conversion_time_ms()), NULL);
+        APP_ERROR_CHECK(err);
+        break;
+
+    case MEASURE_HUMIDITY:
+        measure_data.humidity = hum_code_to_centi(measure_rx[0]<<8 | measure_rx[1]);
+        measure_state = MEASURE_TEMPERATURE;
+        measure_step();
+        break;
+
+    case MEASURE_TEMPERATURE:
+        measure_data.temperature = tmp_code_to_centi(measure_rx[0]<<8 | measure_rx[1]);
+
+        measure_count();
+        NRF_LOG_INFO("Si7021 reading: %u us, CPU awake %u us, %u retries",
+                     perf_ticks_to_us(measure_ticks, perf_ticks()), perf_cycles_to_us(measure_cycles), measure_retries);
+
+        // Idle before the callback, so it can start the next measurement
+        measure_state = MEASURE_IDLE;
+
+        measure_callback(&measure_data, measure_context);
+        break;
+
+    default:
+        NRFX_ASSERT(0);
+        break;
+    }
+}
+
+
+static void measure_timer_handler(void * p_context) {
+    measure_enter();
+    measure_step();
+    measure_count();
+}
+
+
+// The CPU time of a measurement is counted from every place it continues from,
+// the call that starts it and the timer and TWI interrupts
+static inline void measure_enter() {
+    measure_entry_cycles = perf_cycles();
+}
+
+
+static inline void measure_count() {
+    const uint32_t now = perf_cycles();
+
+    measure_cycles += now - measure_entry_cycles;
+    measure_entry_cycles = now;
+}
+
+
+
+#if SI7021_HARDWARE_SAMPLING
+static void sample_init() {
+    nrfx_err_t err;
+    nrfx_rtc_config_t config = NRFX_RTC_DEFAULT_CONFIG;
+
+    config.prescaler = RTC_FREQ_TO_PRESCALER(SAMPLE_RTC_FREQUENCY);
+
+    err = nrfx_rtc_init(&sample_rtc, &config, sample_handler);
+    APP_ERROR_CHECK(err);
+
+    const uint32_t tx_task = nrfx_twim_start_task_get(&instance, NRFX_TWIM_XFER_TX);
+    const uint32_t rx_task = nrfx_twim_start_task_get(&instance, NRFX_TWIM_XFER_RX);
+    // Compare n starts transfer n, the first one also starts the next period
+    const uint32_t tasks[SAMPLE_NUM_TRANSFERS] = { tx_task, rx_task, tx_task, rx_task };
+    const nrf_rtc_event_t events[SAMPLE_NUM_TRANSFERS] = {
+        NRF_RTC_EVENT_COMPARE_0, NRF_RTC_EVENT_COMPARE_1, NRF_RTC_EVENT_COMPARE_2, NRF_RTC_EVENT_COMPARE_3
+    };
+
+    for(size_t i = 0; i < SAMPLE_NUM_TRANSFERS; i++) {
+        err = nrfx_ppi_channel_alloc(&sample_channels[i]);
+        APP_ERROR_CHECK(err);
+        err = nrfx_ppi_channel_assign(sample_channels[i],
+                                      nrfx_rtc_event_address_get(&sample_rtc, events[i]), tasks[i]);
+        APP_ERROR_CHECK(err);
+    }
+
+    err = nrfx_ppi_channel_fork_assign(sample_channels[0], nrfx_rtc_task_address_get(&sample_rtc, NRF_RTC_TASK_CLEAR));
+    APP_ERROR_CHECK(err);
+}
+
+
+// Set up the transfers without starting them, the PPI starts them.
+// The lists move the TWIM to the next command and result after every transfer,
+// and with both LASTTX -> STOP and LASTRX -> STOP every command and every read is a transfer of its own
+static void sample_arm() {
+    const nrfx_twim_xfer_desc_t desc = NRFX_TWIM_XFER_DESC_TXRX(address, sample_tx, 1, sample_rx, 2);
+
+    sample_tx[0] = MSR_HUM_NOHOLD_CMD;
+    sample_tx[1] = GET_TMP_CMD;
+
+    const nrfx_err_t err = nrfx_twim_xfer(&instance, &desc, NRFX_TWIM_FLAG_TX_POSTINC |
+                                                            NRFX_TWIM_FLAG_RX_POSTINC |
+                                                            NRFX_TWIM_FLAG_HOLD_XFER |
+                                                            NRFX_TWIM_FLAG_REPEATED_XFER |
+                                                            NRFX_TWIM_FLAG_NO_XFER_EVT_HANDLER);
+    APP_ERROR_CHECK(err);
+
+    // The driver chains the read to the command (LASTTX -> STARTRX), the sensor is still converting then
+    nrf_twim_shorts_set(instance.p_twim, NRF_TWIM_SHORT_LASTTX_STOP_MASK | NRF_TWIM_SHORT_LASTRX_STOP_MASK);
+}
+
+
+// The read of the temperature starts on the same compare as the interrupt, and takes about 70 us.
+// STOPPED is still set by the earlier transfers, but the read can't be done by the time this is called
+static bool sample_wait_for_read() {
+    const uint32_t start = perf_cycles();
+
+    nrf_twim_event_clear(instance.p_twim, NRF_TWIM_EVENT_STOPPED);
+
+    while(!nrf_twim_event_check(instance.p_twim, NRF_TWIM_EVENT_STOPPED)) {
+        // The driver counts the error once this interrupt returns
+        if(nrf_twim_event_check(instance.p_twim, NRF_TWIM_EVENT_ERROR))
+            return false;
+
+        if(perf_cycles() - start > SAMPLE_WAIT_US * PERF_CYCLES_PER_US)
+            return false;
+    }
+
+    return true;
+}
+
+
+void temperature_sensor_start_sampling(const uint32_t period_ms, const temperature_sensor_callback_t callback, void * const context) {
+    nrfx_err_t err;
+    const uint32_t period_ticks = (period_ms * SAMPLE_RTC_FREQUENCY) / 1000;
+    const uint32_t read_ticks = (conversion_time_ms() * SAMPLE_RTC_FREQUENCY) / 1000 + SAMPLE_READ_MARGIN;
+    const uint32_t ticks[SAMPLE_NUM_TRANSFERS] = {
+        period_ticks,
+        read_ticks,
+        read_ticks + SAMPLE_STEP_TICKS,
+        read_ticks + 2 * SAMPLE_STEP_TICKS,
+    };
+
+    NRFX_ASSERT(callback != NULL);
+    NRFX_ASSERT(measure_state == MEASURE_IDLE);
+    NRFX_ASSERT(period_ticks > ticks[SAMPLE_NUM_TRANSFERS - 1] + SAMPLE_STEP_TICKS);
+
+    sample_callback = callback;
+    sample_context = context;
+    sample_errors = 0;
+    sample_done_ticks = ticks[SAMPLE_NUM_TRANSFERS - 1];
+    measure_state = MEASURE_SAMPLING;
+
+    sample_arm();
+
+    // Only the last compare has an interrupt
+    nrfx_rtc_counter_clear(&sample_rtc);
+
+    for(size_t i = 0; i < SAMPLE_NUM_TRANSFERS; i++) {
+        err = nrfx_rtc_cc_set(&sample_rtc, i, ticks[i], i == SAMPLE_NUM_TRANSFERS - 1);
+        APP_ERROR_CHECK(err);
+        err = nrfx_ppi_channel_enable(sample_channels[i]);
+        APP_ERROR_CHECK(err);
+    }
+
+    // The first period starts now instead of at the first compare 0, otherwise the other compares
+    // come first and start the transfers out of order
+    nrfx_rtc_enable(&sample_rtc);
+    nrf_twim_task_trigger(instance.p_twim, NRF_TWIM_TASK_STARTTX);
+}
+
+
+// Call this right after a sample, so no transfer is cut off
+void temperature_sensor_stop_sampling() {
+    nrfx_err_t err;
+
+    NRFX_ASSERT(measure_state == MEASURE_SAMPLING);
+
+    nrfx_rtc_disable(&sample_rtc);
+
+    for(size_t i = 0; i < SAMPLE_NUM_TRANSFERS; i++) {
+        err = nrfx_ppi_channel_disable(sample_channels[i]);
+        APP_ERROR_CHECK(err);
+    }
+
+    measure_state = MEASURE_IDLE;
+}
+
+
+// The only time the CPU wakes up for a sample, once the last read is on the bus
+static void sample_handler(nrfx_rtc_int_type_t int_type) {
+    nrfx_err_t err;
+    temperature_sensor_data_t data;
+    const uint32_t start = perf_cycles();
+
+    if(int_type != NRFX_RTC_INT_COMPARE3)
+        return;
+
+    // The driver disables a compare after its interrupt
+    err = nrfx_rtc_cc_set(&sample_rtc, SAMPLE_NUM_TRANSFERS - 1, sample_done_ticks, true);
+    APP_ERROR_CHECK(err);
+
+    if(!sample_wait_for_read() || sample_errors > 0) {
+        NRF_LOG_INFO("Si7021: sample dropped after %u TWIM errors", sample_errors);
+        sample_errors = 0;
+        sample_arm();
+        return;
+    }
+
+    data.humidity = hum_code_to_centi(sample_rx[0]<<8 | sample_rx[1]);
+    data.temperature = tmp_code_to_centi(sample_rx[2]<<8 | sample_rx[3]);
+
+    // Back to the start of the lists for the next sample
+    sample_arm();
+
+    NRF_LOG_INFO("Si7021 sample: CPU awake %u us", perf_cycles_to_us(perf_cycles() - start));
+
+    sample_callback(&data, sample_context);
+}
+#endif
@@ -1,16 +1,76 @@
 #ifndef _SI7021_H_
 #define _SI7021_H_
 
+#include <stdint.h>
+#include <stdbool.h>
+
+
+// Sample with the RTC, PPI and TWIM instead of a timer and the CPU
+#ifndef SI7021_HARDWARE_SAMPLING
+#define SI7021_HARDWARE_SAMPLING    1
+#endif
+
+
 typedef struct _temperature_sensor_data {
-    float temperature;
-    float humidity;
+    int16_t temperature;    // Hundredths of a degree Celsius
+    int16_t humidity;       // Hundredths of a percent relative humidity
 } temperature_sensor_data_t;
 
+// To log a value: NRF_LOG_INFO("T: " SENSOR_VALUE_MARKER, SENSOR_VALUE(data.temperature))
+#define SENSOR_VALUE_MARKER     "%s%u.%02u"
+#define SENSOR_VALUE(value)     ((value) < 0 ? "-" : ""), \
+                                (unsigned int)(((value) < 0 ? -(value) : (value)) / 100), \
+                                (unsigned int)(((value) < 0 ? -(value) : (value)) % 100)
+
+// Measurement resolution, the value is the RES1 and RES0 bits of the user register.
+// Lower resolutions convert faster, so they use less energy
+typedef enum {
+    TEMPERATURE_SENSOR_RES_RH12_T14,    // The default
+    TEMPERATURE_SENSOR_RES_RH8_T12,
+    TEMPERATURE_SENSOR_RES_RH10_T13,
+    TEMPERATURE_SENSOR_RES_RH11_T11,
+    TEMPERATURE_SENSOR_NUM_RES
+} temperature_sensor_resolution_t;
+
+// Worst case conversion times from the datasheet.
+// A humidity measurement also measures the temperature, so a reading takes both
+typedef struct _temperature_sensor_timing {
+    uint16_t humidity_us;
+    uint16_t temperature_us;
+} temperature_sensor_timing_t;
+
+// Called from an interrupt when an asynchronous measurement or a sample is done.
+// Data is NULL when an asynchronous measurement failed, the sensor didn't respond
+typedef void (*temperature_sensor_callback_t)(const temperature_sensor_data_t * const data, void * context);
+
 
 void temperature_sensor_init();
 
+// Blocking, the sensor holds the bus for the whole conversion
 temperature_sensor_data_t temperature_sensor_read();
 
+// Start a measurement and return immediately. The bus is free and the CPU can sleep
+// during the conversion, the callback gets the result.
+// Can be called from an interrupt, but not while a measurement is running
+void temperature_sensor_read_async(const temperature_sensor_callback_t callback, void * const context);
+
+bool temperature_sensor_busy();
+
+// Write the resolution to the sensor. Blocking, can't be used while measuring or sampling
+void temperature_sensor_set_resolution(const temperature_sensor_resolution_t resolution);
+temperature_sensor_resolution_t temperature_sensor_get_resolution();
+
+const temperature_sensor_timing_t * temperature_sensor_get_timing(const temperature_sensor_resolution_t resolution);
+
+#if SI7021_HARDWARE_SAMPLING
+// Sample every period_ms without the CPU. RTC compares start each transfer through PPI,
+// the bus is idle while the sensor converts. The CPU only wakes up for the last read,
+// and the callback is called from the RTC interrupt.
+// The other reads can't be used while sampling, stop it from the callback or right after
+void temperature_sensor_start_sampling(const uint32_t period_ms, const temperature_sensor_callback_t callback, void * const context);
+void temperature_sensor_stop_sampling();
+#endif
+
 
 
 
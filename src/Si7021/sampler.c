@@ -0,0 +1,280 @@
+#include "sampler.h"
+
+#include <stddef.h>
+
+#include "nrf.h"
+#include "app_error.h"
+#include "app_timer.h"
+#include <nrf_assert.h>
+#include "log.h"
+#include "perf.h"
+
+
+const sampler_policy_t sampler_policy_fixed = {
+    .name = "fixed",
+    .fast = { .resolution = TEMPERATURE_SENSOR_RES_RH12_T14, .period_ms = 1000 },
+    .slow = { .resolution = TEMPERATURE_SENSOR_RES_RH12_T14, .period_ms = 1000 },
+};
+
+// The rates are well above one step of the slow resolution per slow period,
+// so the rounding of the sensor alone doesn't switch back to fast
+const sampler_policy_t sampler_policy_adaptive = {
+    .name = "adaptive",
+    .fast = { .resolution = TEMPERATURE_SENSOR_RES_RH12_T14, .period_ms = 1000 },
+    .slow = { .resolution = TEMPERATURE_SENSOR_RES_RH10_T13, .period_ms = 10000 },
+    .temperature_rate = 50,
+    .humidity_rate = 200,
+    .stable_samples = 30,
+};
+
+const sampler_policy_t sampler_policy_low_power = {
+    .name = "low power",
+    .fast = { .resolution = TEMPERATURE_SENSOR_RES_RH10_T13, .period_ms = 5000 },
+    .slow = { .resolution = TEMPERATURE_SENSOR_RES_RH8_T12, .period_ms = 60000 },
+    .temperature_rate = 100,
+    .humidity_rate = 300,
+    .stable_samples = 12,
+};
+
+// Indexed by temperature_sensor_resolution_t
+static const char * const resolution_names[] = {
+    "RH 12 bit, T 14 bit",
+    "RH 8 bit, T 12 bit",
+    "RH 10 bit, T 13 bit",
+    "RH 11 bit, T 11 bit",
+};
+
+
+static const sampler_policy_t * policy = &sampler_policy_fixed;
+// NULL until sampling started
+static const sampler_settings_t * settings = NULL;
+static bool fast = true;
+// Samples in a row below the rates of the policy
+static uint16_t stable_samples = 0;
+
+static temperature_sensor_callback_t sample_callback;
+static void * sample_context;
+
+// The last sample at the current settings
+static temperature_sensor_data_t last_data;
+static bool has_last_data = false;
+// When the last sample (or the start of the sampling) was seen, perf_ticks
+static uint32_t last_ticks;
+
+static sampler_stats_t stats = {0};
+
+#if !SI7021_HARDWARE_SAMPLING
+APP_TIMER_DEF(sample_timer);
+static bool sample_timer_created = false;
+#endif
+
+
+static inline bool is_adaptive(const sampler_policy_t * const candidate);
+static inline uint32_t rate_per_minute(const int16_t previous, const int16_t current, const uint32_t interval_ms);
+static inline uint32_t sample_energy_nj(const temperature_sensor_resolution_t resolution);
+static void use_settings(const bool use_fast);
+static void start();
+static void stop();
+#if !SI7021_HARDWARE_SAMPLING
+static void sample_timer_handler(void * p_context);
+#endif
+
+
+
+// A policy with the same fast and slow settings never switches
+static inline bool is_adaptive(const sampler_policy_t * const candidate) {
+    return  candidate->fast.resolution != candidate->slow.resolution ||
+            candidate->fast.period_ms != candidate->slow.period_ms;
+}
+
+
+static inline uint32_t rate_per_minute(const int16_t previous, const int16_t current, const uint32_t interval_ms) {
+    const uint32_t change = current > previous ? current - previous : previous - current;
+
+    return (change * 60000) / interval_ms;
+}
+
+
+// Only the conversions, the standby current and the I2C transfers are left out
+static inline uint32_t sample_energy_nj(const temperature_sensor_resolution_t resolution) {
+    const temperature_sensor_timing_t * const timing = temperature_sensor_get_timing(resolution);
+
+    // uA times us is pC
+    const uint32_t charge_nc = (SAMPLER_HUMIDITY_UA * timing->humidity_us +
+                                SAMPLER_TEMPERATURE_UA * timing->temperature_us) / 1000;
+
+    return (charge_nc * SAMPLER_SUPPLY_MV) / 1000;
+}
+
+
+void sampler_start(const sampler_policy_t * const new_policy, const temperature_sensor_callback_t callback, void * const context) {
+    NRFX_ASSERT(new_policy != NULL);
+    NRFX_ASSERT(callback != NULL);
+    NRFX_ASSERT(settings == NULL);
+
+#if !SI7021_HARDWARE_SAMPLING
+    if(!sample_timer_created) {
+        const ret_code_t err = app_timer_create(&sample_timer, APP_TIMER_MODE_REPEATED, sample_timer_handler);
+        APP_ERROR_CHECK(err);
+        sample_timer_created = true;
+    }
+#endif
+
+    perf_init();
+
+    policy = new_policy;
+    sample_callback = callback;
+    sample_context = context;
+    has_last_data = false;
+    last_ticks = perf_ticks();
+
+    sampler_reset_stats();
+
+    fast = true;
+    settings = &policy->fast;
+    stable_samples = 0;
+
+    start();
+}
+
+
+void sampler_update(const temperature_sensor_data_t * const data) {
+    NRFX_ASSERT(data != NULL);
+    NRFX_ASSERT(settings != NULL);
+
+    // Measured instead of taken from the settings, samples can be skipped or come early after a restart.
+    // The tick counter wraps after 512 s, well above the longest period
+    const uint32_t now = perf_ticks();
+    const uint32_t elapsed_ms = perf_ticks_to_us(last_ticks, now) / 1000;
+    const uint32_t interval_ms = elapsed_ms > 0 ? elapsed_ms : 1;
+    const uint32_t previous_time_ms = stats.time_ms;
+
+    last_ticks = now;
+
+    stats.samples++;
+    stats.fast_samples += fast ? 1 : 0;
+    stats.time_ms += interval_ms;
+    stats.energy_nj += sample_energy_nj(settings->resolution);
+
+    // Only compare samples at the same settings. A restart takes the first sample right away,
+    // so a single step of the new resolution would look like a fast change.
+    // For the same reason the rate is never taken over less than the period
+    const bool compare = has_last_data && is_adaptive(policy);
+    const temperature_sensor_data_t previous = last_data;
+    const uint32_t rate_interval_ms = interval_ms > settings->period_ms ? interval_ms : settings->period_ms;
+
+    last_data = *data;
+    has_last_data = true;
+
+    if(compare) {
+        const bool changing = rate_per_minute(previous.temperature, data->temperature, rate_interval_ms) > policy->temperature_rate ||
+                              rate_per_minute(previous.humidity, data->humidity, rate_interval_ms) > policy->humidity_rate;
+
+        if(changing)
+            stable_samples = 0;
+        else if(stable_samples < UINT16_MAX)
+            stable_samples++;
+
+        // Back to fast on the first change, but only slow down after a while of stable readings
+        if(changing && !fast) {
+            use_settings(true);
+            stats.switches++;
+        } else if(fast && stable_samples >= policy->stable_samples) {
+            use_settings(false);
+            stats.switches++;
+        }
+    }
+
+    if(stats.time_ms / SAMPLER_LOG_INTERVAL_MS != previous_time_ms / SAMPLER_LOG_INTERVAL_MS)
+        sampler_log_stats();
+}
+
+
+void sampler_set_policy(const sampler_policy_t * const new_policy) {
+    NRFX_ASSERT(new_policy != NULL);
+
+    sampler_log_stats();
+    sampler_reset_stats();
+
+    policy = new_policy;
+
+    if(settings != NULL)
+        use_settings(true);
+}
+
+
+// Restart the sampling with the fast or slow settings of the policy
+static void use_settings(const bool use_fast) {
+    stop();
+
+    fast = use_fast;
+    settings = fast ? &policy->fast : &policy->slow;
+    stable_samples = 0;
+    // The next sample is the first at the new settings
+    has_last_data = false;
+
+    start();
+
+    NRF_LOG_INFO("Sampler %s: %s, every %u ms at %s",
+                 policy->name, fast ? "fast" : "slow", settings->period_ms, resolution_names[settings->resolution]);
+}
+
+
+static void start() {
+    temperature_sensor_set_resolution(settings->resolution);
+
+#if SI7021_HARDWARE_SAMPLING
+    temperature_sensor_start_sampling(settings->period_ms, sample_callback, sample_context);
+#else
+    const ret_code_t err = app_timer_start(sample_timer, APP_TIMER_TICKS(settings->period_ms), NULL);
+    APP_ERROR_CHECK(err);
+#endif
+}
+
+
+static void stop() {
+#if SI7021_HARDWARE_SAMPLING
+    temperature_sensor_stop_sampling();
+#else
+    const ret_code_t err = app_timer_stop(sample_timer);
+    APP_ERROR_CHECK(err);
+
+    // The resolution can't change during a measurement, let a running one finish
+    while(temperature_sensor_busy()) {
+        __WFE();
+    }
+#endif
+}
+
+
+#if !SI7021_HARDWARE_SAMPLING
+static void sample_timer_handler(void * p_context) {
+    // Skip a sample when the previous one is still running
+    if(!temperature_sensor_busy())
+        temperature_sensor_read_async(sample_callback, sample_context);
+}
+#endif
+
+
+const sampler_stats_t * sampler_get_stats() {
+    return &stats;
+}
+
+
+void sampler_reset_stats() {
+    stats = (sampler_stats_t) {0};
+}
+
+
+void sampler_log_stats() {
+    if(stats.samples == 0)
+        return;
+
+    const uint32_t conversions_per_hour = ((uint64_t)stats.samples * 3600000) / stats.time_ms;
+    // nJ per ms is uJ per second
+    const uint32_t uj_per_hour = (stats.energy_nj * 3600) / stats.time_ms;
+
+    NRF_LOG_INFO("Sampler %s: %u conversions/h, %u uJ/h, %u%% fast, %u switches in %u s",
+                 policy->name, conversions_per_hour, uj_per_hour,
+                 (stats.fast_samples * 100) / stats.samples, stats.switches, stats.time_ms / 1000);
+}
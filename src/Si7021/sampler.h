@@ -0,0 +1,74 @@
+#ifndef _SAMPLER_H_
+#define _SAMPLER_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "Si7021.h"
+
+
+// Picks how often and at which resolution the Si7021 is sampled.
+// While the readings are stable it samples slow and at a low resolution,
+// as soon as they change faster than the policy allows it goes back to fast and high resolution.
+
+
+// Supply voltage of the sensor, for the energy estimate
+#define SAMPLER_SUPPLY_MV           3300
+
+// Typical supply current of the sensor while converting, from the datasheet
+#define SAMPLER_HUMIDITY_UA         150
+#define SAMPLER_TEMPERATURE_UA      90
+
+// Log the statistics every time this much sampled time has passed
+#define SAMPLER_LOG_INTERVAL_MS     (10 * 60 * 1000)
+
+
+typedef struct _sampler_settings {
+    temperature_sensor_resolution_t resolution;
+    uint32_t period_ms;
+} sampler_settings_t;
+
+typedef struct _sampler_policy {
+    const char * name;
+    sampler_settings_t fast;        // While the readings change
+    sampler_settings_t slow;        // While they are stable
+    uint16_t temperature_rate;      // Hundredths of a degree per minute, a faster change switches to fast
+    uint16_t humidity_rate;         // Hundredths of a percent per minute
+    uint16_t stable_samples;        // Samples in a row below both rates before switching to slow
+} sampler_policy_t;
+
+// Since the policy was set
+typedef struct _sampler_stats {
+    uint32_t samples;               // Each sample is one humidity and one temperature conversion
+    uint32_t fast_samples;
+    uint32_t switches;              // Changes between fast and slow
+    uint32_t time_ms;               // Time covered by the samples
+    uint64_t energy_nj;             // Estimated energy of the conversions
+} sampler_stats_t;
+
+
+// Always the highest resolution once a second, how the sensor was sampled before
+extern const sampler_policy_t sampler_policy_fixed;
+// Once a second while changing, every 10 seconds at a lower resolution when stable
+extern const sampler_policy_t sampler_policy_adaptive;
+// Lower resolutions and a minute between samples when stable
+extern const sampler_policy_t sampler_policy_low_power;
+
+
+// Start sampling at the fast settings of the policy, the callback gets every sample.
+// The callback is called from an interrupt, so it can't call sampler_update itself
+void sampler_start(const sampler_policy_t * const policy, const temperature_sensor_callback_t callback, void * const context);
+
+// Feed a sample to the policy, call this from the main loop for every sample.
+// Changing the settings restarts the sampling, which can't be done from an interrupt
+void sampler_update(const temperature_sensor_data_t * const data);
+
+// Replace the policy, logs and resets the statistics of the old one
+void sampler_set_policy(const sampler_policy_t * const policy);
+
+const sampler_stats_t * sampler_get_stats();
+void sampler_reset_stats();
+void sampler_log_stats();
+
+
+#endif//_SAMPLER_H_
@@ -1,21 +1,33 @@
 #include "ST7735.h"
 
+#include <stdbool.h>
 #include <string.h>
 
+#include "nrf.h"
 #include "nrf_gpio.h"
 #include "nrf_delay.h"
 
 #include "log.h"
 #include "font.h"
+#include "glyph_table.h"
+#include "expand.h"
 #include "spi.h"
+#include "perf.h"
+#include "backlight.h"
 
 
 #define RESET_PIN           20          // 1 is function, 0 is reset
-#define DATA_COMMAND_PIN    22          // 1 is data, 0 is command
-#define BACK_LIGHT_PIN      24          // (PWM) higher is more backlight
+
+#define MEMORY_LINES        162         // Lines (y) in the display memory, the panel shows DISPLAY_HEIGHT of them
 
 #define POWER_UP_TIME_MS    120         // Time in ms that the device needs to power up after reset
 #define RESET_DOWN_TIME_US  10          // Time in us that the reset pin needs to be down for the reset to trigger
+#define SLEEP_OUT_TIME_MS   5           // Time in ms before the next command after sleep out
+#define SLEEP_CHANGE_TIME_MS 120        // Time in ms between a sleep in and out (or out and in)
+
+#define FILL_BUFFER_PIXELS  127         // Pixels repeated when filling, fits in a single EasyDMA transfer (255 bytes)
+#define GLYPH_BUFFER_PIXELS 192         // Pixels per glyph stream buffer, must hold one line of a glyph at ST7735_MAX_SCALE
+#define COMMAND_BUFFER_SIZE 32          // Maximum number of bytes (commands and parameters) in a command list
 
 
 #define PIXEL_RED_BITS          5
@@ -42,7 +54,11 @@
 #define RASET   0x2B
 #define RAMWR   0x2C
 #define PTLAR   0x30
+#define VSCRDEF 0x33
 #define MADCTL  0x36
+#define VSCSAD  0x37
+#define IDMOFF  0x38
+#define IDMON   0x39
 #define COLMOD  0x3A
 #define FRMCTR1 0xB1
 #define FRMCTR2 0xB2
@@ -77,87 +93,192 @@ struct _current_bounds {
     uint16_t num_pixels;
 } static current_bounds;
 
+// Pattern that is repeated by the SPI to fill the bounds, instead of sending pixel by pixel
+static pixel_t fill_buffer[FILL_BUFFER_PIXELS];
+
+// Expansion table for the colors of the last drawn glyph
+static expand_lut_t glyph_lut;
+
+// Two small glyph buffers, lines are rendered into one while the other is being sent.
+// The size doesn't depend on the scale, bigger glyphs just take more buffers.
+// Aligned, since the expansion kernel writes words
+static pixel_t glyph_buffers[2][GLYPH_BUFFER_PIXELS] __attribute__((aligned(4)));
+static volatile bool glyph_buffer_busy[2] = {false, false};
+
+// Command lists are copied here, the SPI sends them in the background.
+// In RAM, since the list can be in flash and EasyDMA can only read RAM
+static uint8_t command_buffer[COMMAND_BUFFER_SIZE];
+static volatile bool command_buffer_busy = false;
+
+static ST7735_mode_t current_mode = ST7735_MODE_NORMAL;
+// Time (perf_ticks) of the last sleep in or out, the display needs time between them
+static uint32_t sleep_change_ticks = 0;
+
+// SPI transactions that were saved by batching commands, compared to sending every byte on its own
+static uint32_t saved_transactions = 0;
+
+// Costs per operation, and the operation that is being counted
+static ST7735_op_stats_t op_stats[ST7735_NUM_OPS];
+static ST7735_op_t op_current;
+static uint8_t op_depth = 0;
+static spi_stats_t op_start_spi;
+static uint32_t op_start_cycles;
+
+static const char * const op_names[] = {
+    [ST7735_OP_BOUNDS] = "bounds",
+    [ST7735_OP_FILL] = "fill",
+    [ST7735_OP_GLYPH] = "glyph",
+    [ST7735_OP_STRING] = "string",
+    [ST7735_OP_PIXELS] = "pixels",
+    [ST7735_OP_CONTROL] = "control",
+};
+
+// Commands to configure the display after a reset.
+// Command list format: command, number of parameters, parameters
+static const uint8_t configure_commands[] = {
+    SLPOUT, 0,                      // Go out of sleep mode
+    COLMOD, 1, 0b00000101,          // 16 bit per pixel (RGB-5-6-5)
+    MADCTL, 1, 0b01000000,          // Invert x-axis (MV-X) to orient the display correctly
+};
+
 
 static void ST7735_gpio_init();
 static void ST7735_reset();
 static void display_configure();
 static inline void ST7735_send_command(uint8_t command);
-static inline void ST7735_send_data(uint8_t data);
-static inline void transfer_pixel(const pixel_t * const pixel);
+static void ST7735_send_commands(const uint8_t * const list, const size_t list_len);
+static void render_glyph_line(const char character, const size_t scale, const size_t line, const pixel_t * const color, pixel_t * const pixels);
+static inline void send_glyph_buffer(const size_t index, const size_t num_pixels);
+static void buffer_done(void * context);
+static void wait_sleep_change();
+static void op_begin(const ST7735_op_t op);
+static void op_end();
+static void draw_glyphs(const uint8_t x, const uint8_t y, const char * const characters, const size_t num_characters, const pixel_t * const color, const size_t scale);
 
 
 
 
-// Need to send the RAMRW command before this function!
-static inline void transfer_pixel(const pixel_t * const pixel) {
-    NRFX_ASSERT(pixel != NULL);
+// Render a single line (FONT_NUM_ROWS * scale pixels) of a glyph, in the order the display expects the pixels
+static void render_glyph_line(const char character,
+                              const size_t scale,
+                              const size_t line,
+                              const pixel_t * const color,
+                              pixel_t * const pixels) {
+    NRFX_ASSERT(character >= 0);
+    NRFX_ASSERT(character < FONT_MAX_CHAR);
 
-    spi_transfer((uint8_t*)&pixel->raw_data, 2);
-}
+    const size_t len = FONT_NUM_ROWS * scale;
+    const uint8_t * const bitmap = glyph_table_get(character, scale);
 
-void ST7735_draw_string(const uint8_t x, const uint8_t y, const char * const string, const pixel_t * const color, const size_t scale) {
-    NRFX_ASSERT(string != NULL);
-    NRFX_ASSERT(scale > 0);
+    if(bitmap != NULL) {
+        // The glyph is already scaled and in the right order, only need to turn the bits into colors
+        expand_bits(&glyph_lut, &bitmap[line * len / 8], len / 8, pixels);
+        return;
+    }
 
-    const size_t len = strlen(string);
+    // Not in the table, scale it here.
+    // The display is rotated, so a line is a bit of every font row
+    const uint8_t bit = line / scale;
+    const pixel_t pixel = { .raw_data = 0xffff };
 
-    // for every character in the string
-    for (size_t i = 0; i < len; i++) {
-        ST7735_draw_character(x, y + (i*FONT_NUM_ROWS*scale), string[i], color, scale);
+    for(size_t i = 0; i < len; i++) {
+        if((font8x8_basic[(uint8_t)character][i / scale] >> bit) & 0x1)
+            pixels[i] = *color;
+        else
+            pixels[i] = pixel;
     }
 }
 
 
-void ST7735_draw_character( const uint8_t x,
-                            const uint8_t y,
-                            const char character,
-                            const pixel_t * const color,
-                            const size_t scale) {
-    NRFX_ASSERT(character >= 0);
-    NRFX_ASSERT(character < FONT_MAX_CHAR);
+static void buffer_done(void * context) {
+    *(volatile bool *)context = false;
+}
+
+
+// Draw characters next to each other (along y) in a single window and a single RAMWR.
+// The glyphs follow each other in the pixel stream, since the display fills x first.
+// Returns without waiting for the last glyph, the next command waits for it.
+static void draw_glyphs(const uint8_t x,
+                        const uint8_t y,
+                        const char * const characters,
+                        const size_t num_characters,
+                        const pixel_t * const color,
+                        const size_t scale) {
+    NRFX_ASSERT(characters != NULL);
     NRFX_ASSERT(scale > 0);
+    NRFX_ASSERT(scale <= ST7735_MAX_SCALE);
 
-    const pixel_t pixel = { .raw_data = 0xffff };
-    const size_t x_len = FONT_NUM_ROWS * scale;
-    const size_t y_len = FONT_NUM_ROWS * scale;
+    const size_t len = FONT_NUM_ROWS * scale;
 
-    pixel_t buffer[x_len][y_len];
+    if(num_characters == 0)
+        return;
 
-    // Set the bounds
-    ST7735_set_bounds(x, y, x_len, y_len);
+    ST7735_set_bounds(x, y, len, len * num_characters);
 
     // Memory write command
     ST7735_send_command(RAMWR);
 
-    // TODO: buffer this and write it all at once
-
-    // Iterate over every pixel in the character
-    for (size_t x = 0; x < FONT_NUM_ROWS; x++) {
-        for (size_t y = 0; y < FONT_NUM_ROWS; y++) {
-            // Set the color if we need to draw anything,
-            // Otherwise, make the pixel white (0xffff)
-            // Also, fuck using the cache, right?
-            if((font8x8_basic[(uint8_t)character][y] >> x) & 0x1)
-                buffer[x * scale][y * scale] = *color;
-            else
-                buffer[x * scale][y * scale] = pixel;
-        }
+    const pixel_t white = { .raw_data = 0xffff };
+    size_t index = 0;
+    size_t used = 0;
+
+    NRFX_ASSERT(len <= GLYPH_BUFFER_PIXELS);
+
+    expand_lut_init(&glyph_lut, color, &white);
+
+    // The previous string can still be sending from this buffer
+    while(glyph_buffer_busy[index]) {
+        __WFE();
     }
 
-    // If we have a scale, than we need to fill in the empty pixels
-    if(scale > 1){
-        for (size_t x = 0; x < x_len; x += scale) {
-            for (size_t y = 0; y < y_len; y += scale) {
-                for(size_t row = 0; row < scale; row++) {
-                    for(size_t col = 0; col < scale; col++) {
-                        buffer[x+row][y+col] = buffer[x][y];
-                    }
+    // Stream line by line, the lines of the next glyph follow the last line of the previous one
+    for(size_t i = 0; i < num_characters; i++) {
+        for(size_t line = 0; line < len; line++) {
+            if(used + len > GLYPH_BUFFER_PIXELS) {
+                send_glyph_buffer(index, used);
+
+                // Continue in the other buffer, which can still be sending
+                index ^= 1;
+                used = 0;
+
+                while(glyph_buffer_busy[index]) {
+                    __WFE();
                 }
             }
+
+            render_glyph_line(characters[i], scale, line, color, &glyph_buffers[index][used]);
+            used += len;
         }
     }
 
-    spi_transfer((uint8_t*)&buffer, sizeof(buffer));
+    send_glyph_buffer(index, used);
+}
+
+
+static inline void send_glyph_buffer(const size_t index, const size_t num_pixels) {
+    glyph_buffer_busy[index] = true;
+    spi_transfer_dc_async((uint8_t*)glyph_buffers[index], num_pixels * sizeof(pixel_t), SPI_DC_DATA,
+                          buffer_done, (void*)&glyph_buffer_busy[index]);
+}
+
+
+void ST7735_draw_string(const uint8_t x, const uint8_t y, const char * const string, const pixel_t * const color, const size_t scale) {
+    NRFX_ASSERT(string != NULL);
+
+    op_begin(ST7735_OP_STRING);
+    draw_glyphs(x, y, string, strlen(string), color, scale);
+    op_end();
+}
+
+
+void ST7735_draw_character( const uint8_t x,
+                            const uint8_t y,
+                            const char character,
+                            const pixel_t * const color,
+                            const size_t scale) {
+    op_begin(ST7735_OP_GLYPH);
+    draw_glyphs(x, y, &character, 1, color, scale);
+    op_end();
 }
 
 // Function to set the drawing bounds on the display
@@ -191,52 +312,305 @@ void ST7735_set_bounds(const uint8_t x, const uint8_t y, const uint8_t x_len, co
 
     // NRF_LOG_INFO("xs: %u, ys: %u, xe: %u, ye: %u", current_bounds.xs, current_bounds.ys, current_bounds.xe, current_bounds.ye);
 
-    // Set the column (xs - xe)
-    ST7735_send_command(CASET);
-    ST7735_send_data(0x00);
-    ST7735_send_data(current_bounds.xs);
-    ST7735_send_data(0x00);
-    ST7735_send_data(current_bounds.xe);
-
-    // Set the row (ys - ye)
-    ST7735_send_command(RASET);
-    ST7735_send_data(0x00);
-    ST7735_send_data(current_bounds.ys);
-    ST7735_send_data(0x00);
-    ST7735_send_data(current_bounds.ye);
+    // Set the column (xs - xe) and the row (ys - ye)
+    const uint8_t window_commands[] = {
+        CASET, 4, 0x00, current_bounds.xs, 0x00, current_bounds.xe,
+        RASET, 4, 0x00, current_bounds.ys, 0x00, current_bounds.ye,
+    };
+
+    op_begin(ST7735_OP_BOUNDS);
+    ST7735_send_commands(window_commands, sizeof(window_commands));
+    op_end();
 }
 
 static inline void ST7735_send_command(uint8_t command) {
+    const uint8_t list[] = { command, 0 };
+
+    ST7735_send_commands(list, sizeof(list));
+}
+
+
+// Queue a command list (see configure_commands for the format).
+// Bytes with the same D/C level are sent as one transaction, so the parameters
+// of a command are a single transfer and commands without parameters are merged.
+// The SPI switches the D/C pin, so this returns without waiting for the bus.
+static void ST7735_send_commands(const uint8_t * const list, const size_t list_len) {
+    NRFX_ASSERT(list != NULL);
+    NRFX_ASSERT(list_len > 0);
+
+    size_t num_bytes = 0;
+    size_t run_start = 0;
+    bool run_is_data = false;
+    const uint32_t start_count = spi_get_transaction_count();
+
+    // The previous list can still be on its way out
+    while(command_buffer_busy) {
+        __WFE();
+    }
+
+    command_buffer_busy = true;
+
+    for(size_t i = 0; i < list_len;) {
+        const uint8_t command = list[i++];
+        const uint8_t num_params = list[i++];
 
-    nrf_gpio_pin_clear(DATA_COMMAND_PIN);
+        NRFX_ASSERT(i + num_params <= list_len);
+        NRFX_ASSERT(num_bytes + 1 + num_params <= COMMAND_BUFFER_SIZE);
 
-    spi_transfer(&command, 1);
+        for(size_t param = 0; param <= num_params; param++) {
+            // The command itself first, then its parameters
+            const bool is_data = param > 0;
+
+            // Queue what we have when the D/C level changes
+            if(num_bytes > run_start && is_data != run_is_data) {
+                spi_transfer_dc_async(&command_buffer[run_start], num_bytes - run_start,
+                                      run_is_data ? SPI_DC_DATA : SPI_DC_COMMAND, NULL, NULL);
+                run_start = num_bytes;
+            }
 
-    nrf_gpio_pin_set(DATA_COMMAND_PIN);
+            command_buffer[num_bytes++] = is_data ? list[i++] : command;
+            run_is_data = is_data;
+        }
+    }
+
+    // The last run frees the buffer
+    spi_transfer_dc_async(&command_buffer[run_start], num_bytes - run_start,
+                          run_is_data ? SPI_DC_DATA : SPI_DC_COMMAND,
+                          buffer_done, (void*)&command_buffer_busy);
+
+    saved_transactions += num_bytes - (spi_get_transaction_count() - start_count);
+}
+
+
+uint32_t ST7735_get_saved_transactions() {
+    return saved_transactions;
 }
 
 
-static inline void ST7735_send_data(uint8_t data) {
-    // Make sure it is set
-    nrf_gpio_pin_set(DATA_COMMAND_PIN);
+// Only the outer operation is counted, the ones it uses are part of its cost
+static void op_begin(const ST7735_op_t op) {
+    if(op_depth++ > 0)
+        return;
 
-    spi_transfer(&data, 1);
+    op_current = op;
+    op_start_spi = *spi_get_stats();
+    op_start_cycles = perf_cycles();
 }
 
 
-void ST7735_fill_bounds(const pixel_t * const color) {
+static void op_end() {
+    NRFX_ASSERT(op_depth > 0);
+
+    if(--op_depth > 0)
+        return;
+
+    const uint32_t cycles = perf_cycles() - op_start_cycles;
+    const spi_stats_t * const spi_stats = spi_get_stats();
+    ST7735_op_stats_t * const stats = &op_stats[op_current];
+
+    stats->calls++;
+    stats->commands += spi_stats->command_bytes - op_start_spi.command_bytes;
+    stats->data_bytes += spi_stats->data_bytes - op_start_spi.data_bytes;
+    stats->transactions += spi_stats->transactions - op_start_spi.transactions;
+    stats->dc_toggles += spi_stats->dc_toggles - op_start_spi.dc_toggles;
+    stats->cycles += cycles;
+
+    if(cycles > stats->max_cycles)
+        stats->max_cycles = cycles;
+}
+
+
+const ST7735_op_stats_t * ST7735_get_op_stats(const ST7735_op_t op) {
+    NRFX_ASSERT(op < ST7735_NUM_OPS);
+
+    return &op_stats[op];
+}
+
+
+void ST7735_reset_op_stats() {
+    memset(op_stats, 0x00, sizeof(op_stats));
+}
+
+
+void ST7735_log_op_stats() {
+    for(size_t op = 0; op < ST7735_NUM_OPS; op++) {
+        const ST7735_op_stats_t * const stats = &op_stats[op];
+
+        if(stats->calls == 0)
+            continue;
+
+        NRF_LOG_INFO("ST7735 %s: %u calls, %u commands, %u data bytes, %u transactions, %u D/C toggles",
+                     op_names[op], stats->calls, stats->commands, stats->data_bytes, stats->transactions, stats->dc_toggles);
+        NRF_LOG_INFO("ST7735 %s: %u cycles, %u at most in one call",
+                     op_names[op], stats->cycles, stats->max_cycles);
+    }
+}
+
+
+void ST7735_write_start() {
+    // Memory write command
+    op_begin(ST7735_OP_PIXELS);
+    ST7735_send_command(RAMWR);
+    op_end();
+}
+
+
+void ST7735_write_pixels(const pixel_t * const pixels, const size_t num_pixels) {
+    NRFX_ASSERT(pixels != NULL);
+
+    if(num_pixels > 0) {
+        op_begin(ST7735_OP_PIXELS);
+        spi_transfer_dc_async((uint8_t*)pixels, num_pixels * sizeof(pixel_t), SPI_DC_DATA, NULL, NULL);
+        spi_wait_idle();
+        op_end();
+    }
+}
+
+
+void ST7735_write_pixels_async(const pixel_t * const pixels,
+                               const size_t num_pixels,
+                               const spi_callback_t callback,
+                               void * const context) {
+    NRFX_ASSERT(pixels != NULL);
+    NRFX_ASSERT(num_pixels > 0);
+
+    op_begin(ST7735_OP_PIXELS);
+    spi_transfer_dc_async((uint8_t*)pixels, num_pixels * sizeof(pixel_t), SPI_DC_DATA, callback, context);
+    op_end();
+}
+
+
+uint32_t ST7735_fill_bounds(const pixel_t * const color) {
     NRFX_ASSERT(color != NULL);
 
+    const uint32_t start_count = spi_get_transaction_count();
+    const uint16_t num_pixels = current_bounds.num_pixels;
+    const uint16_t buffer_len = num_pixels < FILL_BUFFER_PIXELS ? num_pixels : FILL_BUFFER_PIXELS;
+    const uint16_t remainder = num_pixels % buffer_len;
+
+    op_begin(ST7735_OP_FILL);
+
+    // The SPI can still be sending the previous fill
+    spi_wait_idle();
+
+    // Only fill the part of the buffer that we are going to send
+    for(uint16_t i = 0; i < buffer_len; i++) {
+        fill_buffer[i] = *color;
+    }
+
     // Memory write command
     ST7735_send_command(RAMWR);
 
-    // We can speed this up if we use a small buffer to send more data at once
-    // skips initialization overhead of SPI transfer
-    for(uint16_t i = 0; i < current_bounds.num_pixels; i++){
-        transfer_pixel(color);
+    // Whole buffers are repeated by the hardware, the rest is sent after
+    spi_transfer_repeat((uint8_t*)fill_buffer, buffer_len * sizeof(pixel_t), num_pixels / buffer_len, SPI_DC_DATA);
+
+    if(remainder > 0) {
+        spi_transfer_dc_async((uint8_t*)fill_buffer, remainder * sizeof(pixel_t), SPI_DC_DATA, NULL, NULL);
+        spi_wait_idle();
     }
+
+    op_end();
+
+    return spi_get_transaction_count() - start_count;
 }
 
+void ST7735_set_scroll_area(const uint8_t y, const uint8_t y_len) {
+    NRFX_ASSERT(y + y_len <= DISPLAY_HEIGHT);
+    NRFX_ASSERT(y_len > 0);
+
+    // The areas are in memory lines, the panel shows an offset part of them
+    const uint8_t top = y + DISPLAY_Y_START_OFFSET;
+    const uint8_t bottom = MEMORY_LINES - top - y_len;
+
+    const uint8_t scroll_commands[] = {
+        VSCRDEF, 6, 0x00, top, 0x00, y_len, 0x00, bottom,
+    };
+
+    op_begin(ST7735_OP_CONTROL);
+    ST7735_send_commands(scroll_commands, sizeof(scroll_commands));
+    op_end();
+}
+
+
+void ST7735_set_scroll_start(const uint8_t y) {
+    NRFX_ASSERT(y < DISPLAY_HEIGHT);
+
+    const uint8_t scroll_commands[] = {
+        VSCSAD, 2, 0x00, y + DISPLAY_Y_START_OFFSET,
+    };
+
+    op_begin(ST7735_OP_CONTROL);
+    ST7735_send_commands(scroll_commands, sizeof(scroll_commands));
+    op_end();
+}
+
+
+// Wait until we are allowed to go in or out of sleep again
+static void wait_sleep_change() {
+    const uint32_t elapsed_us = perf_ticks_to_us(sleep_change_ticks, perf_ticks());
+
+    if(elapsed_us < SLEEP_CHANGE_TIME_MS * 1000)
+        nrf_delay_us(SLEEP_CHANGE_TIME_MS * 1000 - elapsed_us);
+}
+
+
+void ST7735_set_mode(const ST7735_mode_t mode) {
+    if(mode == current_mode)
+        return;
+
+    op_begin(ST7735_OP_CONTROL);
+
+    // Out of sleep first, the other modes are kept during sleep but we set them again anyway
+    if(current_mode == ST7735_MODE_SLEEP) {
+        wait_sleep_change();
+        ST7735_send_command(SLPOUT);
+        spi_wait_idle();
+        sleep_change_ticks = perf_ticks();
+
+        nrf_delay_ms(SLEEP_OUT_TIME_MS);
+        backlight_enable(true);
+    }
+
+    switch(mode) {
+    case ST7735_MODE_NORMAL: {
+        const uint8_t commands[] = { IDMOFF, 0 };
+        ST7735_send_commands(commands, sizeof(commands));
+        break;
+    }
+
+    case ST7735_MODE_IDLE: {
+        const uint8_t commands[] = { IDMON, 0 };
+        ST7735_send_commands(commands, sizeof(commands));
+        break;
+    }
+
+    case ST7735_MODE_SLEEP:
+        // Nothing to see without the panel, so the backlight can go off too
+        backlight_enable(false);
+
+        wait_sleep_change();
+        ST7735_send_command(SLPIN);
+        spi_wait_idle();
+        sleep_change_ticks = perf_ticks();
+        break;
+
+    default:
+        NRF_LOG_INFO("display incorrect mode: %i", mode);
+        NRFX_ASSERT(0);
+        break;
+    }
+
+    current_mode = mode;
+
+    op_end();
+}
+
+
+ST7735_mode_t ST7735_get_mode() {
+    return current_mode;
+}
+
+
 // TODO: set value to a percentage (0 - COLOR_MAX)
 void pixel_set_color(pixel_t * const pixel, const pixel_colors_t color, const uint8_t percentage) {
     NRFX_ASSERT(pixel != NULL);
@@ -287,45 +661,59 @@ static void ST7735_reset(){
 
 static void ST7735_gpio_init() {
     // Configure the gpio pins as output
+    // The D/C pin belongs to the SPI, which switches it between transfers
+    // The backlight pin belongs to the PWM of the backlight module
     nrf_gpio_cfg_output(RESET_PIN);
-    nrf_gpio_cfg_output(DATA_COMMAND_PIN);
-    nrf_gpio_cfg_output(BACK_LIGHT_PIN);
 
     // Set the correct output
     nrf_gpio_pin_set(RESET_PIN);
-    nrf_gpio_pin_set(DATA_COMMAND_PIN);
-    nrf_gpio_pin_set(BACK_LIGHT_PIN);
 }
 
 
 static void display_configure() {
-    // Go out of sleep mode
-    ST7735_send_command(SLPOUT);
+    op_begin(ST7735_OP_CONTROL);
+    ST7735_send_commands(configure_commands, sizeof(configure_commands));
+    op_end();
 
-    // 16 bit per pixel command (RGB-5-6-5)
-    ST7735_send_command(COLMOD);
-    ST7735_send_data(0b00000101);
-
-    // Invert x-axis (MV-X) to orient the display correctly
-    ST7735_send_command(MADCTL);
-    ST7735_send_data(0b01000000);
+    sleep_change_ticks = perf_ticks();
+    current_mode = ST7735_MODE_NORMAL;
 
     // Set the correct bounds, such that we dont write out of bounds
     ST7735_set_bounds(0, 0, DISPLAY_WIDTH, DISPLAY_HEIGHT);
 
     // Set the display color to white
+    // The cycle counter stops while sleeping, so it only counts the CPU time of the fill
     pixel_t color = {.raw_data = 0xffff};
-    ST7735_fill_bounds(&color);
+    const uint32_t start_ticks = perf_ticks();
+    const uint32_t start_cycles = perf_cycles();
+    const uint32_t transactions = ST7735_fill_bounds(&color);
+    const uint32_t cycles = perf_cycles() - start_cycles;
+    const uint32_t fill_us = perf_ticks_to_us(start_ticks, perf_ticks());
+
+    NRF_LOG_INFO("Display clear took %u SPI transactions, %u us", transactions, fill_us);
+    NRF_LOG_INFO("Display clear CPU time: %u cycles (%u us)", cycles, perf_cycles_to_us(cycles));
 
     // Turn the screen on
+    op_begin(ST7735_OP_CONTROL);
     ST7735_send_command(DISPON);
+    op_end();
 }
 
 void ST7735_init() {
     ST7735_gpio_init();
+    backlight_init();
 
     ST7735_spi_init();
 
+#ifdef SPI_BENCHMARK
+    // Data without a command is ignored by the display, so this is safe to do before configuring
+    spi_benchmark();
+#endif
+
+#ifdef EXPAND_BENCHMARK
+    expand_benchmark();
+#endif
+
     ST7735_reset();
 
     display_configure();
@@ -4,6 +4,8 @@
 #include <stdint.h> // uint8_t
 #include <stddef.h> // size_t
 
+#include "spi.h"
+
 
 // The display size is not the max that the ST7735 can support (132x162).
 // The reported display size is 128x160, but I'm not sure if I missed a
@@ -19,6 +21,9 @@
 #define DISPLAY_HEIGHT          (DISPLAY_Y_STOP_OFFSET - DISPLAY_Y_START_OFFSET + 1)
 #define DISPLAY_NUM_PIXELS      ((DISPLAY_WIDTH) * (DISPLAY_HIGHT))
 
+// Largest scale that can be used to draw characters
+#define ST7735_MAX_SCALE        3
+
 
 
 // 5-6-5 RGB configuration
@@ -41,6 +46,35 @@ typedef struct _pixel {
     };
 } pixel_t;
 
+// Power modes of the display, from most to least power
+typedef enum _ST7735_mode {
+    ST7735_MODE_NORMAL,     // Full color, whole display
+    ST7735_MODE_IDLE,       // 8 colors, only the most significant bit of every color is used
+    ST7735_MODE_SLEEP,      // Panel and backlight off, the memory is kept and can still be written
+} ST7735_mode_t;
+
+// Logical operations the costs are counted for.
+// An operation that uses another one (a string sets bounds) is counted as a whole
+typedef enum _ST7735_op {
+    ST7735_OP_BOUNDS,       // ST7735_set_bounds
+    ST7735_OP_FILL,         // ST7735_fill_bounds
+    ST7735_OP_GLYPH,        // ST7735_draw_character
+    ST7735_OP_STRING,       // ST7735_draw_string
+    ST7735_OP_PIXELS,       // ST7735_write_start and ST7735_write_pixels(_async)
+    ST7735_OP_CONTROL,      // Configuration, power modes and scrolling
+    ST7735_NUM_OPS
+} ST7735_op_t;
+
+typedef struct _ST7735_op_stats {
+    uint32_t calls;
+    uint32_t commands;      // Command bytes
+    uint32_t data_bytes;    // Parameter and pixel bytes
+    uint32_t transactions;
+    uint32_t dc_toggles;
+    uint32_t cycles;        // CPU time of the calls. Asynchronous transfers can still be on the bus when the call returns
+    uint32_t max_cycles;    // Longest call
+} ST7735_op_stats_t;
+
 typedef enum _pixel_colors {
     red,
     green,
@@ -50,12 +84,53 @@ typedef enum _pixel_colors {
 
 void ST7735_draw_character(const uint8_t x, const uint8_t y, const char character, const pixel_t * const color, const size_t scale);
 
+// Draws the whole string in one window, the characters are placed next to each other along y
 void ST7735_draw_string(const uint8_t x, const uint8_t y, const char * const string, const pixel_t * const color, const size_t scale);
 
-void ST7735_fill_bounds(const pixel_t * const color);
+// Fill the current bounds with a single color
+// Returns the number of SPI transactions used for the fill
+uint32_t ST7735_fill_bounds(const pixel_t * const color);
 
 void ST7735_set_bounds(const uint8_t x, const uint8_t y, const uint8_t x_len, const uint8_t y_len);
 
+// Start writing pixels to the current bounds, x increments first, then y.
+// Send the pixels with ST7735_write_pixels, which can be called multiple times
+void ST7735_write_start();
+
+void ST7735_write_pixels(const pixel_t * const pixels, const size_t num_pixels);
+
+// Same as ST7735_write_pixels, but returns right away.
+// The pixels must stay valid until the (optional) callback is called
+void ST7735_write_pixels_async(const pixel_t * const pixels,
+                               const size_t num_pixels,
+                               const spi_callback_t callback,
+                               void * const context);
+
+// Hardware vertical scrolling, the panel shows the lines of the area (along y, over the full width)
+// starting at the scroll start and wrapping around. Writes still go to the unscrolled address.
+// The lines outside the area don't move
+void ST7735_set_scroll_area(const uint8_t y, const uint8_t y_len);
+
+// The line (in display coordinates, within the scroll area) that is shown first in the scroll area
+void ST7735_set_scroll_start(const uint8_t y);
+
+// Switch to a power mode, does nothing if it is already in that mode.
+// Waking up keeps the content, it only waits for the display to leave sleep (not the full reset)
+void ST7735_set_mode(const ST7735_mode_t mode);
+
+ST7735_mode_t ST7735_get_mode();
+
+// Number of SPI transactions saved by sending the parameters of a command as one
+// transfer, compared to sending every byte on its own
+uint32_t ST7735_get_saved_transactions();
+
+// Costs per operation since the last reset
+const ST7735_op_stats_t * ST7735_get_op_stats(const ST7735_op_t op);
+void ST7735_reset_op_stats();
+
+// Log the costs of the operations that were used since the last reset
+void ST7735_log_op_stats();
+
 void pixel_set_color(pixel_t * const pixel, pixel_colors_t color, const uint8_t value);
 
 void ST7735_init();
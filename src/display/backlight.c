@@ -0,0 +1,256 @@
+#include "backlight.h"
+
+#include "nrf_gpio.h"
+#include "nrfx_pwm.h"
+#include "app_timer.h"
+#include "app_error.h"
+
+#include "log.h"
+
+
+#define BACK_LIGHT_PIN      24          // (PWM) higher is more backlight
+
+#define PWM_TOP             1000        // Counts per period, with the 1MHz clock a period is 1ms
+#define FADE_STEPS          32          // Different values in a fade
+#define MINUTES_PER_DAY     (24 * 60)
+#define SCHEDULE_FADE_MS    2000
+
+// The duty cycle is the compare value, the output is high at the start of the period
+#define PWM_RISING_EDGE     0x8000
+
+
+
+static nrfx_pwm_t pwm = NRFX_PWM_INSTANCE(0);
+
+// In RAM, since the PWM reads them with EasyDMA
+static nrf_pwm_values_common_t fade_values[FADE_STEPS];
+static nrf_pwm_values_common_t hold_value;
+
+static uint8_t level = BACKLIGHT_MAX;
+static bool enabled = true;
+static bool pwm_running = false;
+
+APP_TIMER_DEF(schedule_timer);
+static const backlight_schedule_entry_t * schedule = NULL;
+static size_t schedule_len = 0;
+static uint16_t minute_of_day = 0;
+static bool time_known = false;
+static bool timer_running = false;
+
+
+static inline nrf_pwm_values_common_t level_to_value(const uint8_t brightness);
+static void hold_level();
+static void pwm_handler(nrfx_pwm_evt_type_t event_type);
+static void apply_schedule();
+static void update_timer();
+static void schedule_timer_handler(void * p_context);
+
+
+
+static inline nrf_pwm_values_common_t level_to_value(const uint8_t brightness) {
+    return (PWM_TOP * brightness * brightness) / (BACKLIGHT_MAX * BACKLIGHT_MAX) | PWM_RISING_EDGE;
+}
+
+
+// Keep the current level without a sequence, off and fully on don't need the PWM at all
+static void hold_level() {
+    const uint8_t output = enabled ? level : 0;
+
+    if(output == 0 || output == BACKLIGHT_MAX) {
+        // Cleared first, such that the handler ignores this stop
+        if(pwm_running) {
+            pwm_running = false;
+            nrfx_pwm_stop(&pwm, true);
+        }
+
+        // The GPIO drives the pin while the PWM is stopped
+        nrf_gpio_pin_write(BACK_LIGHT_PIN, output == BACKLIGHT_MAX);
+        return;
+    }
+
+    // A single value, looped forever by the PWM
+    hold_value = level_to_value(output);
+
+    const nrf_pwm_sequence_t sequence = {
+        .values.p_common = &hold_value,
+        .length = 1,
+        .repeats = 0,
+        .end_delay = 0
+    };
+
+    nrfx_pwm_simple_playback(&pwm, &sequence, 1, NRFX_PWM_FLAG_LOOP);
+    pwm_running = true;
+}
+
+
+// Called from the interrupt when a fade is done
+static void pwm_handler(nrfx_pwm_evt_type_t event_type) {
+    if(event_type == NRFX_PWM_EVT_STOPPED && pwm_running) {
+        pwm_running = false;
+        hold_level();
+    }
+}
+
+
+void backlight_fade(const uint8_t new_level, const uint16_t duration_ms) {
+    NRFX_ASSERT(new_level <= BACKLIGHT_MAX);
+
+    const uint8_t old_level = enabled ? level : 0;
+    const uint16_t repeats = duration_ms / FADE_STEPS;
+
+    level = new_level;
+
+    if(!enabled || new_level == old_level || repeats == 0) {
+        hold_level();
+        return;
+    }
+
+    for(size_t i = 0; i < FADE_STEPS; i++) {
+        const int32_t step_level = old_level + ((int32_t)(new_level - old_level) * (int32_t)(i + 1)) / FADE_STEPS;
+
+        fade_values[i] = level_to_value(step_level);
+    }
+
+    // Every value is played for repeats + 1 periods of 1ms, then the PWM stops and the handler holds the level
+    const nrf_pwm_sequence_t sequence = {
+        .values.p_common = fade_values,
+        .length = FADE_STEPS,
+        .repeats = repeats - 1,
+        .end_delay = 0
+    };
+
+    pwm_running = true;
+    nrfx_pwm_simple_playback(&pwm, &sequence, 1, NRFX_PWM_FLAG_STOP);
+}
+
+
+void backlight_set(const uint8_t new_level) {
+    NRFX_ASSERT(new_level <= BACKLIGHT_MAX);
+
+    level = new_level;
+    hold_level();
+}
+
+
+uint8_t backlight_get() {
+    return level;
+}
+
+
+void backlight_enable(const bool enable) {
+    if(enable == enabled)
+        return;
+
+    enabled = enable;
+    hold_level();
+}
+
+
+// Fade to the level of the last entry that started, the last entry of yesterday before the first of today
+static void apply_schedule() {
+    if(schedule_len == 0 || !time_known)
+        return;
+
+    const backlight_schedule_entry_t * entry = &schedule[schedule_len - 1];
+
+    for(size_t i = 0; i < schedule_len; i++) {
+        if(schedule[i].minute <= minute_of_day)
+            entry = &schedule[i];
+    }
+
+    if(entry->level != level) {
+        NRF_LOG_INFO("Backlight schedule: %u%%", entry->level);
+        backlight_fade(entry->level, SCHEDULE_FADE_MS);
+    }
+}
+
+
+// The minutes only need counting while there is a schedule to follow
+static void update_timer() {
+    ret_code_t err;
+    const bool needed = schedule_len > 0 && time_known;
+
+    if(needed == timer_running)
+        return;
+
+    // Once a minute is plenty for a schedule in minutes, and it shares the RTC with the other timers
+    if(needed)
+        err = app_timer_start(schedule_timer, APP_TIMER_TICKS(60 * 1000), NULL);
+    else
+        err = app_timer_stop(schedule_timer);
+    APP_ERROR_CHECK(err);
+
+    timer_running = needed;
+}
+
+
+static void schedule_timer_handler(void * p_context) {
+    minute_of_day = (minute_of_day + 1) % MINUTES_PER_DAY;
+
+    apply_schedule();
+}
+
+
+void backlight_set_schedule(const backlight_schedule_entry_t * const entries, const size_t num_entries) {
+    NRFX_ASSERT(entries != NULL || num_entries == 0);
+
+    schedule = entries;
+    schedule_len = num_entries;
+
+    // Without the timer the time goes stale
+    if(schedule_len == 0)
+        time_known = false;
+
+    update_timer();
+    apply_schedule();
+}
+
+
+void backlight_set_time(const uint16_t minute) {
+    ret_code_t err;
+
+    NRFX_ASSERT(minute < MINUTES_PER_DAY);
+
+    minute_of_day = minute;
+    time_known = true;
+
+    // Restart the minute from now
+    if(timer_running) {
+        err = app_timer_stop(schedule_timer);
+        APP_ERROR_CHECK(err);
+        timer_running = false;
+    }
+
+    update_timer();
+    apply_schedule();
+}
+
+
+void backlight_init() {
+    ret_code_t err;
+
+    const nrfx_pwm_config_t config = {
+        .output_pins = {
+            BACK_LIGHT_PIN,
+            NRFX_PWM_PIN_NOT_USED,
+            NRFX_PWM_PIN_NOT_USED,
+            NRFX_PWM_PIN_NOT_USED
+        },
+        .irq_priority = NRFX_PWM_DEFAULT_CONFIG_IRQ_PRIORITY,
+        .base_clock = NRF_PWM_CLK_1MHz,
+        .count_mode = NRF_PWM_MODE_UP,
+        .top_value = PWM_TOP,
+        .load_mode = NRF_PWM_LOAD_COMMON,
+        .step_mode = NRF_PWM_STEP_AUTO
+    };
+
+    err = nrfx_pwm_init(&pwm, &config, pwm_handler);
+    APP_ERROR_CHECK(err);
+
+    // Only started once there is a schedule and a time, see update_timer
+    err = app_timer_create(&schedule_timer, APP_TIMER_MODE_REPEATED, schedule_timer_handler);
+    APP_ERROR_CHECK(err);
+
+    // The driver made the pin an output, start fully on like before
+    hold_level();
+}
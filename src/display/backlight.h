@@ -0,0 +1,49 @@
+#ifndef _BACKLIGHT_H_
+#define _BACKLIGHT_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+
+// Backlight brightness with the PWM peripheral.
+// A fade is a sequence in RAM that the PWM plays on its own, the CPU is only woken at the end.
+// Fully on and fully off don't need the PWM, then it's stopped and the pin is a plain output.
+// Brightness is in percent, it's squared before it goes to the PWM so the steps look even.
+
+
+#define BACKLIGHT_MAX   100
+
+
+// A brightness that starts at a minute of the day
+typedef struct _backlight_schedule_entry {
+    uint16_t minute;            // 0 - 1439
+    uint8_t level;
+} backlight_schedule_entry_t;
+
+
+// Starts at full brightness
+void backlight_init();
+
+void backlight_set(const uint8_t level);
+
+// Fade from the current brightness to a new one
+void backlight_fade(const uint8_t level, const uint16_t duration_ms);
+
+// The brightness we are at, or fading to
+uint8_t backlight_get();
+
+// Turn the light off without forgetting the brightness, for when the display sleeps
+void backlight_enable(const bool enable);
+
+// Fade to the brightness of the schedule when its minute comes.
+// The entries need to be sorted by minute and stay valid, the schedule only runs once the time is set
+void backlight_set_schedule(const backlight_schedule_entry_t * const entries, const size_t num_entries);
+
+// There is no clock on the board, so the time of day needs to come from outside.
+// The time only advances while there is a schedule, so set it after the schedule.
+// Clearing the schedule (no entries) forgets the time
+void backlight_set_time(const uint16_t minute);
+
+
+#endif//_BACKLIGHT_H_
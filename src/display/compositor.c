@@ -0,0 +1,374 @@
+#include "compositor.h"
+
+#include <stdbool.h>
+#include <string.h>
+
+#include "nrf_assert.h"
+
+#include "font.h"
+#include "glyph_table.h"
+#include "expand.h"
+#include "log.h"
+
+
+// Maximum number of separate dirty areas, when we run out they are merged
+#define MAX_DIRTY_RECTS     8
+
+// Pixels composed before sending them to the display, must hold at least one line
+#define LINE_BUFFER_PIXELS  512
+
+
+
+static pixel_t background;
+
+static widget_t widgets[COMPOSITOR_MAX_WIDGETS];
+static size_t num_widgets = 0;
+
+static rect_t dirty_rects[MAX_DIRTY_RECTS];
+// The widget each dirty rect came from, NULL when it covers more than one
+static const widget_t * dirty_owners[MAX_DIRTY_RECTS];
+static size_t num_dirty_rects = 0;
+
+// The rects of the last flush, for things that are drawn on top of the compositor
+static rect_t flushed_rects[MAX_DIRTY_RECTS];
+static size_t num_flushed_rects = 0;
+
+// Next rect to send when flushing in steps
+static size_t flush_index = 0;
+
+// Aligned, since the expansion kernel writes words
+static pixel_t line_buffer[LINE_BUFFER_PIXELS] __attribute__((aligned(4)));
+static expand_lut_t lut;
+
+static compositor_stats_t stats = {0};
+
+
+static inline bool rect_overlaps(const rect_t * const a, const rect_t * const b);
+static inline rect_t rect_union(const rect_t * const a, const rect_t * const b);
+static inline rect_t glyph_rect(const glyph_t * const glyph);
+static inline uint16_t rect_area(const rect_t * const rect);
+static void invalidate(const rect_t * const rect, const widget_t * const owner);
+static void merge_closest_pair();
+static bool rect_has_glyphs(const rect_t * const rect);
+static void compose_line(const rect_t * const rect, const uint8_t y, pixel_t * const line);
+static void flush_rect(const rect_t * const rect);
+
+
+
+static inline bool rect_overlaps(const rect_t * const a, const rect_t * const b) {
+    return  a->x < b->x + b->x_len && b->x < a->x + a->x_len &&
+            a->y < b->y + b->y_len && b->y < a->y + a->y_len;
+}
+
+
+static inline rect_t rect_union(const rect_t * const a, const rect_t * const b) {
+    const uint8_t xs = a->x < b->x ? a->x : b->x;
+    const uint8_t ys = a->y < b->y ? a->y : b->y;
+    const uint8_t xe = a->x + a->x_len > b->x + b->x_len ? a->x + a->x_len : b->x + b->x_len;
+    const uint8_t ye = a->y + a->y_len > b->y + b->y_len ? a->y + a->y_len : b->y + b->y_len;
+
+    return (rect_t) { .x = xs, .y = ys, .x_len = xe - xs, .y_len = ye - ys };
+}
+
+
+static inline rect_t glyph_rect(const glyph_t * const glyph) {
+    const uint8_t len = FONT_NUM_ROWS * glyph->scale;
+
+    return (rect_t) { .x = glyph->x, .y = glyph->y, .x_len = len, .y_len = len };
+}
+
+
+static inline uint16_t rect_area(const rect_t * const rect) {
+    return rect->x_len * rect->y_len;
+}
+
+
+void compositor_init(const pixel_t * const color) {
+    NRFX_ASSERT(color != NULL);
+
+    background = *color;
+    num_widgets = 0;
+    num_dirty_rects = 0;
+    num_flushed_rects = 0;
+    flush_index = 0;
+}
+
+
+widget_t * compositor_widget_create(const pixel_t * const color) {
+    NRFX_ASSERT(color != NULL);
+    NRFX_ASSERT(num_widgets < COMPOSITOR_MAX_WIDGETS);
+
+    widget_t * const widget = &widgets[num_widgets++];
+
+    memset(widget, 0x00, sizeof(*widget));
+    widget->color = *color;
+
+    return widget;
+}
+
+
+void widget_set_glyphs(widget_t * const widget, const glyph_t * const glyphs, const uint8_t num_glyphs) {
+    NRFX_ASSERT(widget != NULL);
+    NRFX_ASSERT(num_glyphs <= WIDGET_MAX_GLYPHS);
+
+    const uint8_t num_slots = widget->num_glyphs > num_glyphs ? widget->num_glyphs : num_glyphs;
+
+    // Compare slot by slot, such that only the glyphs that changed are redrawn
+    for(uint8_t i = 0; i < num_slots; i++) {
+        const bool had_glyph = i < widget->num_glyphs;
+        const bool has_glyph = i < num_glyphs;
+
+        if(had_glyph && has_glyph && memcmp(&widget->glyphs[i], &glyphs[i], sizeof(glyph_t)) == 0)
+            continue;
+
+        // The old glyph needs to be erased, the new one drawn.
+        // Usually they are in the same place and the two rects are merged
+        if(had_glyph) {
+            const rect_t rect = glyph_rect(&widget->glyphs[i]);
+            invalidate(&rect, widget);
+        }
+
+        if(has_glyph) {
+            const rect_t rect = glyph_rect(&glyphs[i]);
+            invalidate(&rect, widget);
+        }
+    }
+
+    memcpy(widget->glyphs, glyphs, num_glyphs * sizeof(glyph_t));
+    widget->num_glyphs = num_glyphs;
+}
+
+
+void compositor_invalidate(const rect_t * const rect) {
+    invalidate(rect, NULL);
+}
+
+
+static void invalidate(const rect_t * const rect, const widget_t * const owner) {
+    NRFX_ASSERT(rect != NULL);
+    NRFX_ASSERT(rect->x + rect->x_len <= DISPLAY_WIDTH);
+    NRFX_ASSERT(rect->y + rect->y_len <= DISPLAY_HEIGHT);
+
+    rect_t merged = *rect;
+    const widget_t * merged_owner = owner;
+    bool merging = true;
+
+    // Keep merging until the new rect no longer overlaps any of the others,
+    // a merge can make the rect grow into a rect it didn't overlap before
+    while(merging) {
+        merging = false;
+
+        for(size_t i = 0; i < num_dirty_rects; i++) {
+            if(rect_overlaps(&merged, &dirty_rects[i])) {
+                merged = rect_union(&merged, &dirty_rects[i]);
+                merged_owner = merged_owner == dirty_owners[i] ? merged_owner : NULL;
+
+                // Remove the rect by moving the last one in its place
+                num_dirty_rects--;
+                dirty_rects[i] = dirty_rects[num_dirty_rects];
+                dirty_owners[i] = dirty_owners[num_dirty_rects];
+                merging = true;
+                break;
+            }
+        }
+    }
+
+    dirty_rects[num_dirty_rects] = merged;
+    dirty_owners[num_dirty_rects] = merged_owner;
+    num_dirty_rects++;
+
+    // Out of space, make room for the next one
+    if(num_dirty_rects == MAX_DIRTY_RECTS)
+        merge_closest_pair();
+}
+
+
+// Merge the two rects whose union adds the least area.
+// The union of two rects that don't overlap covers pixels in between, which get erased to the
+// background. Those can belong to things drawn directly (lines, sparklines), so only rects of
+// the same widget are merged, their union stays in the area of that readout.
+// Rects of more than one widget are only merged when there is no other choice
+static void merge_closest_pair() {
+    size_t best_a = 0;
+    size_t best_b = 1;
+    uint32_t best_growth = UINT32_MAX;
+    bool best_owned = false;
+
+    for(size_t a = 0; a < num_dirty_rects; a++) {
+        for(size_t b = a + 1; b < num_dirty_rects; b++) {
+            const rect_t merged = rect_union(&dirty_rects[a], &dirty_rects[b]);
+            const uint32_t growth = rect_area(&merged) - rect_area(&dirty_rects[a]) - rect_area(&dirty_rects[b]);
+            const bool owned = dirty_owners[a] != NULL && dirty_owners[a] == dirty_owners[b];
+
+            if((owned && !best_owned) || (owned == best_owned && growth < best_growth)) {
+                best_a = a;
+                best_b = b;
+                best_growth = growth;
+                best_owned = owned;
+            }
+        }
+    }
+
+    dirty_rects[best_a] = rect_union(&dirty_rects[best_a], &dirty_rects[best_b]);
+    dirty_owners[best_a] = best_owned ? dirty_owners[best_a] : NULL;
+
+    // Remove the rect by moving the last one in its place
+    num_dirty_rects--;
+    dirty_rects[best_b] = dirty_rects[num_dirty_rects];
+    dirty_owners[best_b] = dirty_owners[num_dirty_rects];
+
+    // The union can overlap others now, merge those like a new rect
+    const rect_t merged = dirty_rects[best_a];
+    const widget_t * const owner = dirty_owners[best_a];
+
+    num_dirty_rects--;
+    dirty_rects[best_a] = dirty_rects[num_dirty_rects];
+    dirty_owners[best_a] = dirty_owners[num_dirty_rects];
+
+    invalidate(&merged, owner);
+}
+
+
+// Check if any glyph is (partly) inside the rect
+static bool rect_has_glyphs(const rect_t * const rect) {
+    for(size_t w = 0; w < num_widgets; w++) {
+        for(size_t g = 0; g < widgets[w].num_glyphs; g++) {
+            const rect_t glyph = glyph_rect(&widgets[w].glyphs[g]);
+
+            if(rect_overlaps(rect, &glyph))
+                return true;
+        }
+    }
+
+    return false;
+}
+
+
+// Compose a single line (one y, the width of the rect) from all widgets
+static void compose_line(const rect_t * const rect, const uint8_t y, pixel_t * const line) {
+    for(size_t i = 0; i < rect->x_len; i++) {
+        line[i] = background;
+    }
+
+    for(size_t w = 0; w < num_widgets; w++) {
+        const widget_t * const widget = &widgets[w];
+
+        for(size_t g = 0; g < widget->num_glyphs; g++) {
+            const glyph_t * const glyph = &widget->glyphs[g];
+            const uint8_t len = FONT_NUM_ROWS * glyph->scale;
+
+            // Skip glyphs that are not on this line or not in the rect
+            if(y < glyph->y || y >= glyph->y + len)
+                continue;
+            if(glyph->x >= rect->x + rect->x_len || glyph->x + len <= rect->x)
+                continue;
+
+            const uint8_t xs = glyph->x > rect->x ? glyph->x : rect->x;
+            const uint8_t xe = glyph->x + len < rect->x + rect->x_len ? glyph->x + len : rect->x + rect->x_len;
+            const uint8_t * const bitmap = glyph_table_get(glyph->character, glyph->scale);
+
+            pixel_t * const dest = &line[xs - rect->x];
+
+            if(bitmap != NULL && xs == glyph->x && xe == glyph->x + len && ((uintptr_t)dest % 4) == 0) {
+                // The whole line of the glyph is in the rect and word aligned, use the kernel
+                expand_lut_init(&lut, &widget->color, &background);
+                expand_bits(&lut, &bitmap[(y - glyph->y) * len / 8], len / 8, dest);
+            } else if(bitmap != NULL) {
+                // Pre-scaled, the bits of this line follow each other
+                for(uint8_t x = xs; x < xe; x++) {
+                    const size_t bit = (y - glyph->y) * len + (x - glyph->x);
+
+                    if((bitmap[bit / 8] >> (bit % 8)) & 0x1)
+                        line[x - rect->x] = widget->color;
+                }
+            } else {
+                // The display is rotated, so a font row is along x and a font column along y
+                const uint8_t column = (y - glyph->y) / glyph->scale;
+
+                for(uint8_t x = xs; x < xe; x++) {
+                    const uint8_t row = (x - glyph->x) / glyph->scale;
+
+                    if((font8x8_basic[(uint8_t)glyph->character][row] >> column) & 0x1)
+                        line[x - rect->x] = widget->color;
+                }
+            }
+        }
+    }
+}
+
+
+static void flush_rect(const rect_t * const rect) {
+    size_t used = 0;
+
+    ST7735_set_bounds(rect->x, rect->y, rect->x_len, rect->y_len);
+    stats.pixels += rect->x_len * rect->y_len;
+
+    // Glyphs that were removed only need to be erased, no need to compose anything
+    if(!rect_has_glyphs(rect)) {
+        ST7735_fill_bounds(&background);
+        stats.fills++;
+        return;
+    }
+
+    ST7735_write_start();
+
+    // The display fills the bounds line by line, x first
+    for(uint8_t y = rect->y; y < rect->y + rect->y_len; y++) {
+        if(used + rect->x_len > LINE_BUFFER_PIXELS) {
+            ST7735_write_pixels(line_buffer, used);
+            used = 0;
+        }
+
+        compose_line(rect, y, &line_buffer[used]);
+        used += rect->x_len;
+    }
+
+    ST7735_write_pixels(line_buffer, used);
+}
+
+
+bool compositor_flush_step() {
+    // Take over the dirty rects, anything invalidated while flushing goes to the next flush
+    if(flush_index == 0) {
+        memcpy(flushed_rects, dirty_rects, num_dirty_rects * sizeof(rect_t));
+        num_flushed_rects = num_dirty_rects;
+        num_dirty_rects = 0;
+
+        stats.pixels = 0;
+        stats.fills = 0;
+        stats.rects = num_flushed_rects;
+    }
+
+    if(flush_index < num_flushed_rects)
+        flush_rect(&flushed_rects[flush_index++]);
+
+    if(flush_index < num_flushed_rects)
+        return true;
+
+    flush_index = 0;
+    stats.total_pixels += stats.pixels;
+
+    return false;
+}
+
+
+void compositor_flush() {
+    while(compositor_flush_step());
+}
+
+
+bool compositor_was_flushed(const rect_t * const rect) {
+    NRFX_ASSERT(rect != NULL);
+
+    for(size_t i = 0; i < num_flushed_rects; i++) {
+        if(rect_overlaps(rect, &flushed_rects[i]))
+            return true;
+    }
+
+    return false;
+}
+
+
+const compositor_stats_t * compositor_get_stats() {
+    return &stats;
+}
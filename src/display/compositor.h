@@ -0,0 +1,77 @@
+#ifndef _COMPOSITOR_H_
+#define _COMPOSITOR_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#include "ST7735.h"
+
+
+// Retained mode drawing layer on top of the ST7735 driver.
+// Widgets hold what should be on the screen, when a glyph of a widget changes the
+// area it covers is marked dirty. Flushing only sends the dirty areas to the display.
+// The compositor owns every pixel inside a dirty area, so widgets should not
+// overlap with things that are drawn directly with the ST7735 functions.
+
+
+#define COMPOSITOR_MAX_WIDGETS  8
+#define WIDGET_MAX_GLYPHS       8
+
+
+typedef struct _rect {
+    uint8_t x;
+    uint8_t y;
+    uint8_t x_len;
+    uint8_t y_len;
+} rect_t;
+
+// A single character placed on the screen
+typedef struct _glyph {
+    uint8_t x;
+    uint8_t y;
+    uint8_t scale;
+    char character;
+} glyph_t;
+
+typedef struct _widget {
+    glyph_t glyphs[WIDGET_MAX_GLYPHS];
+    uint8_t num_glyphs;
+    pixel_t color;
+} widget_t;
+
+typedef struct _compositor_stats {
+    uint32_t pixels;            // Pixels sent during the last flush
+    uint16_t rects;             // Number of (merged) dirty rectangles in the last flush
+    uint16_t fills;             // Rectangles of the last flush that were only erased
+    uint32_t total_pixels;      // Pixels sent since boot
+} compositor_stats_t;
+
+
+void compositor_init(const pixel_t * const color);
+
+// Returns a new, empty widget. Widgets can't be removed
+widget_t * compositor_widget_create(const pixel_t * const color);
+
+// Replace the glyphs of a widget. Glyphs are compared per slot (index in the array),
+// only the slots that changed are marked dirty
+void widget_set_glyphs(widget_t * const widget, const glyph_t * const glyphs, const uint8_t num_glyphs);
+
+// Mark an area dirty, overlapping areas are merged
+void compositor_invalidate(const rect_t * const rect);
+
+// Send all dirty areas to the display
+void compositor_flush();
+
+// Send one dirty area, for callers that spread a flush over several passes.
+// Returns true while there are areas left to send
+bool compositor_flush_step();
+
+// Check if the last flush (partly) painted over an area.
+// Used by things that are drawn directly next to the widgets, to know when they need a redraw
+bool compositor_was_flushed(const rect_t * const rect);
+
+const compositor_stats_t * compositor_get_stats();
+
+
+#endif//_COMPOSITOR_H_
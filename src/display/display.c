@@ -1,14 +1,19 @@
 #include "display.h"
 
-#include <stdlib.h>
 #include <string.h>
 
 #include "nrf_assert.h"
 
 #include "ST7735.h"
+#include "compositor.h"
+#include "segment.h"
+#include "graph.h"
+#include "sparkline.h"
+#include "render.h"
 #include "Si7021.h"
 #include "font.h"
 #include "log.h"
+#include "perf.h"
 
 #define SCALE_BIG       3
 #define SCALE_NORMAL    2
@@ -24,95 +29,506 @@
 #define HUMI_X          (ROW*4*SCALE_NORMAL)
 #define BORDER_PIXELS   4
 
-
-static pixel_t color;
+// Top left of the readouts, the temp/humi strings are above them
+#define READOUT_TEMP_X  (TEMP_X - FONT_NUM_ROWS/2)
+#define READOUT_HUMI_X  (HUMI_X - FONT_NUM_ROWS/2)
+// This offset is the size of the TEMP/HUMI string
+#define INSIDE_Y        (FONT_NUM_ROWS + (strlen(TEMP_STR) * FONT_NUM_ROWS * SCALE_NORMAL))
+// Offset to the middle of the screen, one normal sized character extra
+#define OUTSIDE_Y       (DISPLAY_HEIGHT/2 + FONT_NUM_ROWS * SCALE_NORMAL)
+
+// Two big characters fit between the top of a readout and the line (or edge) below it.
+// Whole numbers with more characters (100 %, -10 degrees and below) are drawn at the normal scale.
+// Three fit at that scale, far below what the sensors can measure, in hundredths
+#define READOUT_BIG_LEN 2
+#define READOUT_MIN     (-9994)
+
+// Temperature history along the bottom of the display, in tenths of a degree
+#define GRAPH_HEIGHT    28
+#define GRAPH_X         (DISPLAY_WIDTH - GRAPH_HEIGHT)
+#define GRAPH_MIN       (-100)
+#define GRAPH_MAX       400
+// Wall time per sample, so the graph shows the last 160 * 10 seconds whatever the sensor period is
+#define GRAPH_INTERVAL_MS   10000
+// Samples added after a long gap between updates, more would only scroll out the same value
+#define GRAPH_MAX_CATCH_UP  SPARK_LEN
+
+// Trend of a readout, below its big digits. One sample per line, so the last 48 samples
+#define SPARK_HEIGHT    8
+#define SPARK_LEN       48
+#define SPARK_OFFSET    (FONT_NUM_ROWS * SCALE_BIG)
+#define SPARK_TEMP_STEP 10      // The range of the temperature changes in steps of 1 degree
+#define SPARK_HUMI_STEP 20      // And humidity in steps of 2 percent
+
+// Updates without changes before display_power_policy_idle switches to idle mode
+#define IDLE_UPDATES    60
+
+
+// The readouts, in the order of the frame jobs
+enum {
+    INSIDE_TEMP,
+    INSIDE_HUMI,
+    OUTSIDE_TEMP,
+    OUTSIDE_HUMI,
+    NUM_READOUTS
+};
+
+typedef struct _readout {
+    widget_t * widget;              // The small unit and decimal, the compositor only redraws the ones that changed
+    segment_display_t digits;       // The big whole number, as seven segment digits
+    sparkline_t trend;
+    int16_t trend_step;
+    char unit;
+    int16_t value;                  // What the current frame draws, in hundredths
+    uint8_t trend_added;            // Samples the current frame added to the trend
+} readout_t;
+
+// Static text and lines, drawn once by the init jobs
+typedef struct _label {
+    uint8_t x;
+    uint8_t y;
+    const char * text;
+    uint8_t scale;
+} label_t;
+
+typedef struct _line {
+    uint8_t xs;
+    uint8_t ys;
+    uint8_t xe;
+    uint8_t ye;
+} line_t;
+
+
+static const label_t labels[] = {
+    // Inside and outside at the top of the display
+    { .x = ROW/2, .y = FONT_NUM_ROWS, .text = INSIDE_STR, .scale = SCALE_BIG },
+    { .x = ROW/2, .y = DISPLAY_HEIGHT - (FONT_NUM_ROWS*(sizeof(OUTSIDE_STR) - 1)*SCALE_BIG), .text = OUTSIDE_STR, .scale = SCALE_BIG },
+    // The temp and humi strings below this
+    { .x = TEMP_X, .y = BORDER_PIXELS, .text = TEMP_STR, .scale = SCALE_NORMAL },
+    { .x = HUMI_X, .y = BORDER_PIXELS, .text = HUMI_STR, .scale = SCALE_NORMAL },
+};
+
+// 2 fancy lines in a T-Shape do differenciate between Outside and Inside
+static const line_t lines[] = {
+    { .xs = 26, .ys = DISPLAY_HEIGHT/2, .xe = GRAPH_X - BORDER_PIXELS, .ye = DISPLAY_HEIGHT/2 },
+    { .xs = 26, .ys = 10, .xe = 26, .ye = DISPLAY_HEIGHT - 10 },
+};
 
 
-static inline void draw_temp(const uint8_t x, const uint8_t y, const float temp);
-static inline void draw_humi(const uint8_t x, const uint8_t y, const float humi);
+static pixel_t color;
+static pixel_t background = { .raw_data = 0xffff };
+
+static readout_t readouts[NUM_READOUTS];
+
+static graph_t history;
+// Wall time since the last sample of the graph, the first update takes one right away
+static uint32_t graph_ticks;
+static uint32_t graph_elapsed_ms = GRAPH_INTERVAL_MS;
+
+// The latest sensor data, taken over by the next frame
+static int16_t latest_values[NUM_READOUTS];
+// A frame is queued or being drawn, and new data arrived since it started
+static bool frame_active = false;
+static bool update_pending = false;
+
+// Measurements of the current frame
+static uint32_t frame_ticks;
+static uint32_t frame_saved;
+static uint32_t frame_layout_cycles;
+// Samples for the graph and trends, one per GRAPH_INTERVAL_MS since the last one
+static uint8_t frame_samples;
+static uint8_t graph_added;
+
+static display_power_policy_t power_policy = display_power_policy_normal;
+static display_activity_t activity = {0};
+// Time (perf_ticks) of the last change of power mode
+static uint32_t mode_ticks = 0;
+
+static const char * const mode_names[] = {
+    [ST7735_MODE_NORMAL] = "normal",
+    [ST7735_MODE_IDLE] = "idle",
+    [ST7735_MODE_SLEEP] = "sleep",
+};
+
+
+static void readout_init(readout_t * const readout, const uint8_t x, const uint8_t y, const char unit, const int16_t trend_step);
+static void push_frame();
+static bool job_label(void * context);
+static bool job_line(void * context);
+static bool job_graph_init(void * context);
+static bool job_trend_init(void * context);
+static bool job_frame_start(void * context);
+static bool job_layout(void * context);
+static bool job_flush(void * context);
+static bool job_digits(void * context);
+static bool job_graph(void * context);
+static bool job_trend(void * context);
+static bool job_frame_end(void * context);
+static void apply_power_policy(const bool changed);
+static inline uint8_t format_value(const int16_t value, char * const whole);
+static inline uint8_t layout_value(glyph_t * const glyphs, segment_display_t * const digits, const int16_t value, const char unit);
 
 
 
 void display_init(){
+    perf_init();
     ST7735_init();
 
     pixel_set_color(&color, red, 10);
     pixel_set_color(&color, green, 10);
     pixel_set_color(&color, blue, 55);
 
-    // Draw inside and outside at the top of the display
-    ST7735_draw_string(ROW/2, FONT_NUM_ROWS, INSIDE_STR, &color, SCALE_BIG);
-    ST7735_draw_string(ROW/2, DISPLAY_HEIGHT - (FONT_NUM_ROWS*strlen(OUTSIDE_STR)*SCALE_BIG), OUTSIDE_STR, &color, SCALE_BIG);
+    compositor_init(&background);
+
+    graph_ticks = perf_ticks();
+
+    readout_init(&readouts[INSIDE_TEMP], READOUT_TEMP_X, INSIDE_Y, FONT_DEGREE_MARK, SPARK_TEMP_STEP);
+    readout_init(&readouts[INSIDE_HUMI], READOUT_HUMI_X, INSIDE_Y, '%', SPARK_HUMI_STEP);
+    readout_init(&readouts[OUTSIDE_TEMP], READOUT_TEMP_X, OUTSIDE_Y, FONT_DEGREE_MARK, SPARK_TEMP_STEP);
+    readout_init(&readouts[OUTSIDE_HUMI], READOUT_HUMI_X, OUTSIDE_Y, '%', SPARK_HUMI_STEP);
+
+    // Everything else is drawn by the render queue, from the main loop
+    for(size_t i = 0; i < sizeof(labels) / sizeof(labels[0]); i++) {
+        render_push(job_label, (void *)&labels[i]);
+    }
+
+    for(size_t i = 0; i < sizeof(lines) / sizeof(lines[0]); i++) {
+        render_push(job_line, (void *)&lines[i]);
+    }
+
+    render_push(job_graph_init, NULL);
+
+    for(size_t i = 0; i < NUM_READOUTS; i++) {
+        render_push(job_trend_init, &readouts[i]);
+    }
+}
+
+
+static void readout_init(readout_t * const readout, const uint8_t x, const uint8_t y, const char unit, const int16_t trend_step) {
+    readout->widget = compositor_widget_create(&color);
+    readout->unit = unit;
+    readout->trend_step = trend_step;
+    readout->value = 0;
+
+    segment_display_init(&readout->digits, x, y, SCALE_BIG, &color, &background);
+}
 
-    // Draw the temp and humi strings below this
-    ST7735_draw_string(TEMP_X, BORDER_PIXELS, TEMP_STR, &color, SCALE_NORMAL);
-    ST7735_draw_string(HUMI_X, BORDER_PIXELS, HUMI_STR, &color, SCALE_NORMAL);
 
-    // Draw 2 fancy lines in a T-Shape do differenciate between Outside and Inside
-    display_draw_line(26, DISPLAY_HEIGHT/2, DISPLAY_WIDTH - 10, DISPLAY_HEIGHT/2, &color);
-    display_draw_line(26, 10, 26, DISPLAY_HEIGHT - 10, &color);
+bool display_process() {
+    return render_run();
 }
 
 
 void display_set_sensor_data(   const temperature_sensor_data_t * const inside_data,
                                 const temperature_sensor_data_t * const outside_data) {
 
-    // This offset is the size of the TEMP/HUMI string
-    uint8_t y_offset = FONT_NUM_ROWS + (strlen(TEMP_STR) * FONT_NUM_ROWS * SCALE_NORMAL);
+    latest_values[INSIDE_TEMP] = inside_data->temperature;
+    latest_values[INSIDE_HUMI] = inside_data->humidity;
+    latest_values[OUTSIDE_TEMP] = outside_data->temperature;
+    latest_values[OUTSIDE_HUMI] = outside_data->humidity;
 
-    // inside data
-    draw_temp(TEMP_X - FONT_NUM_ROWS/2, y_offset, inside_data->temperature);
-    draw_humi(HUMI_X - FONT_NUM_ROWS/2, y_offset, inside_data->humidity);
+    // Don't queue frames behind each other, the running frame starts the next one with the latest data
+    if(frame_active)
+        update_pending = true;
+    else
+        push_frame();
+}
+
+
+// Queue all jobs of one update
+static void push_frame() {
+    const uint32_t now = perf_ticks();
+
+    // The tick counter wraps after 512 s, longer gaps count short
+    graph_elapsed_ms += perf_ticks_to_us(graph_ticks, now) / 1000;
+    graph_ticks = now;
+
+    frame_active = true;
+    frame_samples = graph_elapsed_ms / GRAPH_INTERVAL_MS > GRAPH_MAX_CATCH_UP ? GRAPH_MAX_CATCH_UP : graph_elapsed_ms / GRAPH_INTERVAL_MS;
+    graph_elapsed_ms %= GRAPH_INTERVAL_MS;
+    graph_added = 0;
+
+    render_push(job_frame_start, NULL);
 
-    // Offset to the middle of the screen, one normal sized character extra
-    y_offset = DISPLAY_HEIGHT/2 + FONT_NUM_ROWS * SCALE_NORMAL;
+    // Segments that turn off are erased here, before the compositor draws the units that may have moved there
+    for(size_t i = 0; i < NUM_READOUTS; i++) {
+        render_push(job_layout, &readouts[i]);
+    }
 
-    draw_temp(TEMP_X - FONT_NUM_ROWS/2, y_offset, outside_data->temperature);
-    draw_humi(HUMI_X - FONT_NUM_ROWS/2, y_offset, outside_data->humidity);
+    // Only the readouts that changed are sent to the display, one rect per call
+    render_push(job_flush, NULL);
+
+    // The segments that turn on go last, so the compositor can't paint over them
+    for(size_t i = 0; i < NUM_READOUTS; i++) {
+        render_push(job_digits, &readouts[i]);
+    }
+
+    // Only one line of the graph is sent per sample, one sample per job call
+    if(frame_samples > 0) {
+        render_push(job_graph, NULL);
+
+        for(size_t i = 0; i < NUM_READOUTS; i++) {
+            readouts[i].trend_added = 0;
+            render_push(job_trend, &readouts[i]);
+        }
+    }
+
+    render_push(job_frame_end, NULL);
 }
 
 
+static bool job_label(void * context) {
+    const label_t * const label = context;
 
+    ST7735_draw_string(label->x, label->y, label->text, &color, label->scale);
 
-static inline void draw_temp(const uint8_t x, const uint8_t y, const float temp) {
-    char buffer[5];
-    const int itemp = (int)temp;
-    const unsigned int dec = (int)((temp - itemp) * 10);
-    const size_t len = itemp >= 10 ? 2 : 1;
+    return true;
+}
 
-    // Draw the temperature by first drawing the whole number
-    __itoa(itemp, buffer, 10);
-    ST7735_draw_string(x, y, buffer, &color, SCALE_BIG);
 
-    // Then the little °C at the end
-    ST7735_draw_character(x, y + (len * FONT_NUM_ROWS * SCALE_BIG), FONT_DEGREE_MARK, &color, SCALE_SMAL);
+static bool job_line(void * context) {
+    const line_t * const line = context;
 
-    // Then the decimal
-    __itoa(dec, buffer, 10);
-    ST7735_draw_string(x + 1.5*ROW, y + (len * FONT_NUM_ROWS * SCALE_BIG), buffer, &color, SCALE_SMAL);
+    display_draw_line(line->xs, line->ys, line->xe, line->ye, &color);
+
+    return true;
 }
 
 
+// Inside and outside temperature history below everything else
+static bool job_graph_init(void * context) {
+    const rect_t graph_area = { .x = GRAPH_X, .y = 0, .x_len = GRAPH_HEIGHT, .y_len = DISPLAY_HEIGHT };
+    pixel_t outside_color = { .raw_data = 0 };
 
-static inline void draw_humi(const uint8_t x, const uint8_t y, const float humi) {
-    char buffer[5];
-    const int ihumi = (int)humi;
-    const unsigned int dec = (int)((humi - ihumi) * 10);
-    const size_t len = ihumi >= 10 ? 2 : 1;
+    pixel_set_color(&outside_color, red, 80);
+    pixel_set_color(&outside_color, green, 30);
 
-    // Draw the humidity by first drawing the whole number
-    __itoa(ihumi, buffer, 10);
-    ST7735_draw_string(x, y, buffer, &color, SCALE_BIG);
+    graph_init(&history, &graph_area, GRAPH_MIN, GRAPH_MAX, &background);
+    graph_add_series(&history, &color);
+    graph_add_series(&history, &outside_color);
 
-    // Then the little % at the end
-    ST7735_draw_string(x, y + (len * FONT_NUM_ROWS * SCALE_BIG), "%", &color, SCALE_SMAL);
+    return true;
+}
 
-    // Then the decimal
-    __itoa(dec, buffer, 10);
-    ST7735_draw_string(x + 1.5*ROW, y + (len * FONT_NUM_ROWS * SCALE_BIG), buffer, &color, SCALE_SMAL);
+
+// The trend of a readout goes below its big digits
+static bool job_trend_init(void * context) {
+    readout_t * const readout = context;
+    const rect_t area = {
+        .x = readout->digits.x + SPARK_OFFSET,
+        .y = readout->digits.y,
+        .x_len = SPARK_HEIGHT,
+        .y_len = SPARK_LEN
+    };
+
+    sparkline_init(&readout->trend, &area, readout->trend_step, &color, &background);
+
+    return true;
+}
+
+
+static bool job_frame_start(void * context) {
+    for(size_t i = 0; i < NUM_READOUTS; i++) {
+        readouts[i].value = latest_values[i];
+    }
+
+    frame_ticks = perf_ticks();
+    frame_saved = ST7735_get_saved_transactions();
+    frame_layout_cycles = 0;
+
+    segment_reset_stats();
+    sparkline_reset_stats();
+
+    return true;
+}
+
+
+static bool job_layout(void * context) {
+    readout_t * const readout = context;
+    glyph_t glyphs[WIDGET_MAX_GLYPHS];
+    const uint32_t start_cycles = perf_cycles();
+    const uint8_t num_glyphs = layout_value(glyphs, &readout->digits, readout->value, readout->unit);
+
+    frame_layout_cycles += perf_cycles() - start_cycles;
+
+    widget_set_glyphs(readout->widget, glyphs, num_glyphs);
+
+    return true;
+}
+
+
+static bool job_flush(void * context) {
+    return !compositor_flush_step();
+}
+
+
+static bool job_digits(void * context) {
+    readout_t * const readout = context;
+
+    segment_display_draw(&readout->digits);
+
+    return true;
 }
 
 
+static bool job_graph(void * context) {
+    const int16_t temperatures[] = {
+        readouts[INSIDE_TEMP].value / 10,
+        readouts[OUTSIDE_TEMP].value / 10,
+    };
+
+    graph_add_sample(&history, temperatures);
+
+    return ++graph_added >= frame_samples;
+}
+
+
+static bool job_trend(void * context) {
+    readout_t * const readout = context;
+
+    sparkline_add_sample(&readout->trend, readout->value / 10);
+
+    return ++readout->trend_added >= frame_samples;
+}
+
+
+static bool job_frame_end(void * context) {
+    const uint32_t us = perf_ticks_to_us(frame_ticks, perf_ticks());
+    const uint32_t saved = ST7735_get_saved_transactions() - frame_saved;
+    const compositor_stats_t * const stats = compositor_get_stats();
+    const segment_stats_t * const segment_stats = segment_get_stats();
+
+    if(stats->pixels > 0)
+        NRF_LOG_INFO("Display update: %u pixels in %u rects, %u us, %u SPI transactions saved",
+                     stats->pixels, stats->rects, us, saved);
+
+    if(segment_stats->bitmap_bytes > 0)
+        NRF_LOG_INFO("Big digits: %u bytes as segments, %u bytes as glyphs",
+                     segment_stats->bytes, segment_stats->bitmap_bytes);
+
+    if(frame_samples > 0) {
+        const sparkline_stats_t * const spark_stats = sparkline_get_stats();
+        const render_stats_t * const render_stats = render_get_stats();
+
+        NRF_LOG_INFO("Sparklines: %u fills, %u pixels, %u repaints",
+                     spark_stats->fills, spark_stats->pixels, spark_stats->repaints);
+        NRF_LOG_INFO("Render: %u jobs in %u passes, longest pass %u us, %u queued at most",
+                     render_stats->jobs, render_stats->passes, render_stats->max_pass_us, render_stats->max_queued);
+        NRF_LOG_INFO("Readouts: formatted and laid out in %u cycles", frame_layout_cycles);
+
+        // The display costs of the updates since the last sample
+        NRF_LOG_INFO("Display operations since the last sample:");
+        ST7735_log_op_stats();
+        ST7735_reset_op_stats();
+    }
+
+    // Anything drawn counts, the readouts as well as a new sample of the graph and trends
+    apply_power_policy(stats->pixels > 0 || segment_stats->bitmap_bytes > 0 || frame_samples > 0);
+
+    frame_active = false;
+
+    if(update_pending) {
+        update_pending = false;
+        push_frame();
+    }
+
+    return true;
+}
+
+
+void display_set_power_policy(const display_power_policy_t policy) {
+    NRFX_ASSERT(policy != NULL);
+
+    power_policy = policy;
+}
+
+
+ST7735_mode_t display_power_policy_normal(const display_activity_t * const activity) {
+    return ST7735_MODE_NORMAL;
+}
+
+
+ST7735_mode_t display_power_policy_idle(const display_activity_t * const activity) {
+    return activity->unchanged_updates >= IDLE_UPDATES ? ST7735_MODE_IDLE : ST7735_MODE_NORMAL;
+}
+
+
+// Let the policy pick the mode, and log how long we were in the previous one
+static void apply_power_policy(const bool changed) {
+    const ST7735_mode_t current = ST7735_get_mode();
+
+    activity.updates++;
+    activity.unchanged_updates = changed ? 0 : activity.unchanged_updates + 1;
+
+    const ST7735_mode_t mode = power_policy(&activity);
+
+    if(mode == current)
+        return;
+
+    const uint32_t now = perf_ticks();
+
+    ST7735_set_mode(mode);
+    NRF_LOG_INFO("Display mode %s, after %u ms in %s",
+                 mode_names[mode], perf_ticks_to_us(mode_ticks, now) / 1000, mode_names[current]);
+
+    mode_ticks = now;
+}
+
+
+
+
+// Split a value in hundredths into the whole number as text and the decimal, rounded to tenths.
+// Only divides by constants, which the compiler turns into multiplications.
+// Returns the decimal
+static inline uint8_t format_value(const int16_t value, char * const whole) {
+    char reversed[5];
+    size_t len = 0;
+    size_t i = 0;
+    const uint16_t tenths = ((value < 0 ? -value : value) + 5) / 10;
+    uint16_t units = tenths / 10;
+
+    do {
+        reversed[len++] = '0' + (units % 10);
+        units /= 10;
+    } while(units > 0);
+
+    // Keep the sign of values between -1 and 0, they show as -0
+    if(value < 0 && tenths > 0)
+        whole[i++] = '-';
+
+    while(len > 0)
+        whole[i++] = reversed[--len];
+
+    whole[i] = '\0';
+
+    return tenths % 10;
+}
+
+
+// Layout of a readout: the whole number big, followed by the unit with the decimal below it
+// Returns the number of glyphs used
+static inline uint8_t layout_value(glyph_t * const glyphs, segment_display_t * const digits, const int16_t value, const char unit) {
+    char buffer[7];
+    uint8_t num_glyphs = 0;
+    const uint8_t x = digits->x;
+    const uint8_t y = digits->y;
+
+    // First the whole number, smaller when it doesn't fit at the big scale
+    const uint8_t dec = format_value(value < READOUT_MIN ? READOUT_MIN : value, buffer);
+    const size_t len = strlen(buffer);
+    const uint8_t scale = len > READOUT_BIG_LEN ? SCALE_NORMAL : SCALE_BIG;
+
+    segment_display_set_scale(digits, scale);
+    segment_display_set(digits, buffer);
+
+    // Then the little unit at the end
+    glyphs[num_glyphs++] = (glyph_t) { .x = x, .y = y + (len * FONT_NUM_ROWS * scale), .scale = SCALE_SMAL, .character = unit };
+
+    // Then the decimal
+    glyphs[num_glyphs++] = (glyph_t) { .x = x + (3*ROW)/2, .y = y + (len * scale * FONT_NUM_ROWS), .scale = SCALE_SMAL, .character = '0' + dec };
+
+    return num_glyphs;
+}
 
 
 // Can only draw straight lines one pixel wide
@@ -2,6 +2,9 @@
 #define _DISPLAY_H_
 
 #include <stdint.h>
+#include <stdbool.h>
+
+#include "ST7735.h"
 
 
 // Forward declaration of struct, to prevent a include
@@ -9,12 +12,38 @@ typedef struct _temperature_sensor_data temperature_sensor_data_t;
 typedef struct _pixel pixel_t;
 
 
+// What the power policy bases its decision on
+typedef struct _display_activity {
+    uint32_t updates;               // Sensor updates since boot
+    uint32_t unchanged_updates;     // Updates in a row that did not change anything on the display
+} display_activity_t;
+
+// Picks the power mode of the display, called after every update
+typedef ST7735_mode_t (*display_power_policy_t)(const display_activity_t * const activity);
+
+
+// Resets the display, the rest of the screen is drawn by display_process
 void display_init();
 
+// Run a slice of the queued drawing, call this from the main loop.
+// Returns true when there is drawing left, the main loop should not sleep then
+bool display_process();
+
 
 void display_set_sensor_data(const temperature_sensor_data_t * const inside_data, const temperature_sensor_data_t * const outside_data);
 
 
+// Replace the power policy, the default is display_power_policy_normal
+void display_set_power_policy(const display_power_policy_t policy);
+
+// Always full color
+ST7735_mode_t display_power_policy_normal(const display_activity_t * const activity);
+
+// Drop to 8 colors when nothing changed for a while, back to full color on the next change.
+// The dim colors of the UI turn fully saturated in 8 colors, so this is opt-in
+ST7735_mode_t display_power_policy_idle(const display_activity_t * const activity);
+
+
 // Can only draw straight lines
 // So xs == xe and ys != ye
 // Or ys == ye and xs != xe
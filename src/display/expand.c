@@ -0,0 +1,98 @@
+#include "expand.h"
+
+#ifdef EXPAND_BENCHMARK
+#include "log.h"
+#include "perf.h"
+#endif
+
+
+
+void expand_lut_init(expand_lut_t * const lut, const pixel_t * const foreground, const pixel_t * const background) {
+    // A zero initialized table is valid for black on black, so this check also works the first time
+    if(lut->foreground.raw_data == foreground->raw_data &&
+       lut->background.raw_data == background->raw_data)
+        return;
+
+    // Little endian, so the first pixel goes in the lower half of a word
+    for(uint32_t nibble = 0; nibble < 16; nibble++) {
+        uint16_t pixels[4];
+
+        for(uint32_t bit = 0; bit < 4; bit++) {
+            pixels[bit] = ((nibble >> bit) & 0x1) ? foreground->raw_data : background->raw_data;
+        }
+
+        lut->nibbles[nibble][0] = pixels[0] | ((uint32_t)pixels[1] << 16);
+        lut->nibbles[nibble][1] = pixels[2] | ((uint32_t)pixels[3] << 16);
+    }
+
+    lut->foreground = *foreground;
+    lut->background = *background;
+}
+
+
+void expand_bits(const expand_lut_t * const lut, const uint8_t * bits, const size_t num_bytes, pixel_t * const pixels) {
+    uint32_t * out = (uint32_t*)pixels;
+    const uint8_t * const end = bits + num_bytes;
+
+    while(bits < end) {
+        const uint32_t * const low = lut->nibbles[*bits & 0xF];
+        const uint32_t * const high = lut->nibbles[*bits >> 4];
+
+        out[0] = low[0];
+        out[1] = low[1];
+        out[2] = high[0];
+        out[3] = high[1];
+
+        out += 4;
+        bits++;
+    }
+}
+
+
+#ifdef EXPAND_BENCHMARK
+// The loop used before the kernel, one bit and one pixel at a time
+static void expand_bits_per_pixel(const pixel_t * const foreground, const pixel_t * const background,
+                                  const uint8_t * const bits, const size_t num_bytes, pixel_t * const pixels) {
+    for(size_t i = 0; i < num_bytes * 8; i++) {
+        pixels[i] = ((bits[i / 8] >> (i % 8)) & 0x1) ? *foreground : *background;
+    }
+}
+
+
+void expand_benchmark() {
+    // The size of a glyph at scale 3
+    static uint8_t bits[72];
+    static pixel_t pixels[72 * 8] __attribute__((aligned(4)));
+    static expand_lut_t lut;
+    const pixel_t foreground = { .raw_data = 0x1234 };
+    const pixel_t background = { .raw_data = 0xffff };
+    const size_t rounds = 100;
+    uint32_t start, per_pixel, kernel, init;
+
+    perf_init();
+
+    for(size_t i = 0; i < sizeof(bits); i++) {
+        bits[i] = (uint8_t)(i * 37);
+    }
+
+    start = perf_cycles();
+    for(size_t i = 0; i < rounds; i++) {
+        expand_bits_per_pixel(&foreground, &background, bits, sizeof(bits), pixels);
+    }
+    per_pixel = perf_cycles() - start;
+
+    start = perf_cycles();
+    expand_lut_init(&lut, &foreground, &background);
+    init = perf_cycles() - start;
+
+    start = perf_cycles();
+    for(size_t i = 0; i < rounds; i++) {
+        expand_bits(&lut, bits, sizeof(bits), pixels);
+    }
+    kernel = perf_cycles() - start;
+
+    NRF_LOG_INFO("Expand %u pixels: per pixel %u cycles, kernel %u cycles (+%u once for the table)",
+                 sizeof(pixels) / sizeof(pixels[0]), per_pixel / rounds, kernel / rounds, init);
+    log_flush();
+}
+#endif
@@ -0,0 +1,38 @@
+#ifndef _EXPAND_H_
+#define _EXPAND_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "ST7735.h"
+
+
+// Kernel to turn packed 1 bit per pixel data (least significant bit first) into pixels.
+// Every nibble of input is looked up in a table holding the 4 matching pixels as two
+// 32 bit words, so a byte of input costs 2 loads and 4 word stores.
+// The table is built from pixel_t, which is already in the byte order the ST7735
+// expects, so no byte swapping is needed while expanding.
+
+
+typedef struct _expand_lut {
+    pixel_t foreground;
+    pixel_t background;
+    uint32_t nibbles[16][2];
+} expand_lut_t;
+
+
+// (Re)build the table, does nothing if the colors did not change.
+// The table needs to be zero initialized before the first call (e.g. static)
+void expand_lut_init(expand_lut_t * const lut, const pixel_t * const foreground, const pixel_t * const background);
+
+// Expand num_bytes of bits into num_bytes * 8 pixels.
+// The pixels need to be 4-byte aligned, since they are written as words
+void expand_bits(const expand_lut_t * const lut, const uint8_t * bits, const size_t num_bytes, pixel_t * const pixels);
+
+#ifdef EXPAND_BENCHMARK
+// Log the cycles of the kernel compared to expanding bit by bit
+void expand_benchmark();
+#endif
+
+
+#endif//_EXPAND_H_
@@ -0,0 +1,201 @@
+#include "framebuffer.h"
+
+#if FRAMEBUFFER_ENABLED
+
+#include <stdbool.h>
+#include <string.h>
+
+#include "nrf_assert.h"
+
+#include "font.h"
+#include "log.h"
+#include "perf.h"
+
+
+#define LINE_BYTES      (DISPLAY_WIDTH / 2)
+#define DIRTY_WORDS     ((DISPLAY_HEIGHT + 31) / 32)
+
+
+
+// Two pixels per byte, the even x in the low nibble
+static uint8_t framebuffer[DISPLAY_HEIGHT][LINE_BYTES];
+static pixel_t palette[FRAMEBUFFER_PALETTE_SIZE];
+
+// One bit per line
+static uint32_t dirty_lines[DIRTY_WORDS];
+
+// A line is expanded into one buffer while the other is being sent.
+// Aligned, since two pixels are written as one word
+static pixel_t line_buffers[2][DISPLAY_WIDTH] __attribute__((aligned(4)));
+static volatile bool line_buffer_busy[2] = {false, false};
+
+
+static inline void mark_dirty(const uint8_t y);
+static inline bool is_dirty(const uint8_t y);
+static inline void set_pixel(const uint8_t x, const uint8_t y, const uint8_t index);
+static void expand_line(const uint8_t y, pixel_t * const pixels);
+static void line_buffer_done(void * context);
+
+
+
+static inline void mark_dirty(const uint8_t y) {
+    dirty_lines[y / 32] |= 1UL << (y % 32);
+}
+
+
+static inline bool is_dirty(const uint8_t y) {
+    return (dirty_lines[y / 32] >> (y % 32)) & 0x1;
+}
+
+
+static inline void set_pixel(const uint8_t x, const uint8_t y, const uint8_t index) {
+    uint8_t * const byte = &framebuffer[y][x / 2];
+
+    if(x % 2)
+        *byte = (*byte & 0x0f) | (index << 4);
+    else
+        *byte = (*byte & 0xf0) | index;
+}
+
+
+void framebuffer_init(const pixel_t * const colors) {
+    NRFX_ASSERT(colors != NULL);
+
+    memcpy(palette, colors, sizeof(palette));
+    memset(framebuffer, 0x00, sizeof(framebuffer));
+    memset(dirty_lines, 0xff, sizeof(dirty_lines));
+
+    NRF_LOG_INFO("Framebuffer: %u bytes of RAM, RGB565 would be %u bytes",
+                 (uint32_t)(sizeof(framebuffer) + sizeof(line_buffers)), (uint32_t)(DISPLAY_WIDTH * DISPLAY_HEIGHT * sizeof(pixel_t)));
+}
+
+
+void framebuffer_set_palette(const uint8_t index, const pixel_t * const color) {
+    NRFX_ASSERT(index < FRAMEBUFFER_PALETTE_SIZE);
+    NRFX_ASSERT(color != NULL);
+
+    if(palette[index].raw_data == color->raw_data)
+        return;
+
+    // We don't know where the color is used, so send everything again
+    palette[index] = *color;
+    memset(dirty_lines, 0xff, sizeof(dirty_lines));
+}
+
+
+void framebuffer_set_pixel(const uint8_t x, const uint8_t y, const uint8_t index) {
+    NRFX_ASSERT(x < DISPLAY_WIDTH);
+    NRFX_ASSERT(y < DISPLAY_HEIGHT);
+    NRFX_ASSERT(index < FRAMEBUFFER_PALETTE_SIZE);
+
+    set_pixel(x, y, index);
+    mark_dirty(y);
+}
+
+
+void framebuffer_fill_rect(const uint8_t x, const uint8_t y, const uint8_t x_len, const uint8_t y_len, const uint8_t index) {
+    NRFX_ASSERT(x + x_len <= DISPLAY_WIDTH);
+    NRFX_ASSERT(y + y_len <= DISPLAY_HEIGHT);
+    NRFX_ASSERT(index < FRAMEBUFFER_PALETTE_SIZE);
+
+    for(uint8_t line = y; line < y + y_len; line++) {
+        for(uint8_t column = x; column < x + x_len; column++) {
+            set_pixel(column, line, index);
+        }
+
+        mark_dirty(line);
+    }
+}
+
+
+void framebuffer_draw_glyph(const uint8_t x, const uint8_t y, const char character, const uint8_t scale, const uint8_t index) {
+    NRFX_ASSERT(character >= 0);
+    NRFX_ASSERT(character < FONT_MAX_CHAR);
+    NRFX_ASSERT(x + FONT_NUM_ROWS * scale <= DISPLAY_WIDTH);
+    NRFX_ASSERT(y + FONT_NUM_ROWS * scale <= DISPLAY_HEIGHT);
+
+    const uint8_t len = FONT_NUM_ROWS * scale;
+
+    // The display is rotated, so a font row is along x and a font column along y
+    for(uint8_t line = 0; line < len; line++) {
+        for(uint8_t column = 0; column < len; column++) {
+            if((font8x8_basic[(uint8_t)character][column / scale] >> (line / scale)) & 0x1)
+                set_pixel(x + column, y + line, index);
+        }
+
+        mark_dirty(y + line);
+    }
+}
+
+
+// Turn a line of indices into pixels, a byte holds two pixels which are written as one word
+static void expand_line(const uint8_t y, pixel_t * const pixels) {
+    const uint8_t * const line = framebuffer[y];
+    uint32_t * const words = (uint32_t *)pixels;
+
+    for(size_t i = 0; i < LINE_BYTES; i++) {
+        const uint8_t byte = line[i];
+
+        words[i] = palette[byte & 0x0f].raw_data | ((uint32_t)palette[byte >> 4].raw_data << 16);
+    }
+}
+
+
+static void line_buffer_done(void * context) {
+    *(volatile bool *)context = false;
+}
+
+
+void framebuffer_flush() {
+    const uint32_t start_ticks = perf_ticks();
+    const uint32_t start_cycles = perf_cycles();
+    size_t index = 0;
+    uint16_t num_lines = 0;
+
+    for(uint8_t y = 0; y < DISPLAY_HEIGHT;) {
+        if(!is_dirty(y)) {
+            y++;
+            continue;
+        }
+
+        // Find the end of this run of dirty lines, they are sent in a single window
+        uint8_t end = y;
+        while(end < DISPLAY_HEIGHT && is_dirty(end)) {
+            end++;
+        }
+
+        ST7735_set_bounds(0, y, DISPLAY_WIDTH, end - y);
+        ST7735_write_start();
+
+        for(; y < end; y++) {
+            // Wait until the line that was in this buffer is sent
+            while(line_buffer_busy[index]) {
+                __WFE();
+            }
+
+            expand_line(y, line_buffers[index]);
+
+            line_buffer_busy[index] = true;
+            ST7735_write_pixels_async(line_buffers[index], DISPLAY_WIDTH, line_buffer_done, (void*)&line_buffer_busy[index]);
+
+            index ^= 1;
+            num_lines++;
+        }
+    }
+
+    // The line buffers are reused by the next flush
+    spi_wait_idle();
+    memset(dirty_lines, 0x00, sizeof(dirty_lines));
+
+    if(num_lines > 0) {
+        const uint32_t cycles = perf_cycles() - start_cycles;
+        const uint32_t us = perf_ticks_to_us(start_ticks, perf_ticks());
+        const uint32_t bytes = num_lines * DISPLAY_WIDTH * sizeof(pixel_t);
+
+        NRF_LOG_INFO("Framebuffer flush: %u lines, %u bytes in %u us (%u kB/s)",
+                     num_lines, bytes, us, us > 0 ? (bytes * 1000) / us / 1024 : 0);
+        NRF_LOG_INFO("Framebuffer flush CPU time: %u cycles", cycles);
+    }
+}
+
+#endif
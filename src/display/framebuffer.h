@@ -0,0 +1,44 @@
+#ifndef _FRAMEBUFFER_H_
+#define _FRAMEBUFFER_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "ST7735.h"
+
+
+// Off-screen framebuffer with 4 bits per pixel, every pixel is an index in a 16 color palette.
+// The whole display takes DISPLAY_WIDTH * DISPLAY_HEIGHT / 2 bytes (10KB), a quarter of RGB565.
+// Drawing only changes the buffer and marks the lines (one y, all x) dirty,
+// flushing expands the dirty lines through the palette while they are sent.
+
+// Set to 1 to include the framebuffer, it costs 10KB of RAM
+#ifndef FRAMEBUFFER_ENABLED
+#define FRAMEBUFFER_ENABLED     0
+#endif
+
+#define FRAMEBUFFER_PALETTE_SIZE    16
+
+
+#if FRAMEBUFFER_ENABLED
+
+// Clears the buffer to color 0 and marks everything dirty
+void framebuffer_init(const pixel_t * const palette);
+
+// Changing a color that is in use marks everything dirty
+void framebuffer_set_palette(const uint8_t index, const pixel_t * const color);
+
+void framebuffer_set_pixel(const uint8_t x, const uint8_t y, const uint8_t index);
+
+void framebuffer_fill_rect(const uint8_t x, const uint8_t y, const uint8_t x_len, const uint8_t y_len, const uint8_t index);
+
+// Only the lit pixels of the glyph are drawn, so glyphs can be drawn over anything
+void framebuffer_draw_glyph(const uint8_t x, const uint8_t y, const char character, const uint8_t scale, const uint8_t index);
+
+// Send the dirty lines to the display, consecutive lines share a single window
+void framebuffer_flush();
+
+#endif
+
+
+#endif//_FRAMEBUFFER_H_
@@ -0,0 +1,360 @@
+// Generated by tools/gen_glyph_table.py from font.c, do not edit
+#include "glyph_table.h"
+
+
+const int8_t glyph_table_index[FONT_MAX_CHAR] = {
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, 12, -1, -1, -1, -1, -1, -1, -1, 10, 11, -1,
+     0,  1,  2,  3,  4,  5,  6,  7,  8,  9, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, 19, 13, -1, -1, -1, -1, -1, 15,
+    -1, -1, -1, -1, 18, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 14, -1,
+    -1, -1, -1, -1, 17, 16, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    20,
+};
+
+const uint8_t glyph_table_scale1[][GLYPH_TABLE_SIZE(1)] = {
+    {   // '0'
+        0x3E, 0x7F, 0x71, 0x59, 0x4D, 0x7F, 0x3E, 0x00,
+    },
+    {   // '1'
+        0x40, 0x42, 0x7F, 0x7F, 0x40, 0x40, 0x00, 0x00,
+    },
+    {   // '2'
+        0x62, 0x73, 0x59, 0x49, 0x6F, 0x66, 0x00, 0x00,
+    },
+    {   // '3'
+        0x22, 0x63, 0x49, 0x49, 0x7F, 0x36, 0x00, 0x00,
+    },
+    {   // '4'
+        0x18, 0x1C, 0x16, 0x53, 0x7F, 0x7F, 0x50, 0x00,
+    },
+    {   // '5'
+        0x27, 0x67, 0x45, 0x45, 0x7D, 0x39, 0x00, 0x00,
+    },
+    {   // '6'
+        0x3C, 0x7E, 0x4B, 0x49, 0x79, 0x30, 0x00, 0x00,
+    },
+    {   // '7'
+        0x03, 0x03, 0x71, 0x79, 0x0F, 0x07, 0x00, 0x00,
+    },
+    {   // '8'
+        0x36, 0x7F, 0x49, 0x49, 0x7F, 0x36, 0x00, 0x00,
+    },
+    {   // '9'
+        0x06, 0x4F, 0x49, 0x69, 0x3F, 0x1E, 0x00, 0x00,
+    },
+    {   // '-'
+        0x08, 0x08, 0x08, 0x08, 0x08, 0x08, 0x00, 0x00,
+    },
+    {   // '.'
+        0x00, 0x00, 0x60, 0x60, 0x00, 0x00, 0x00, 0x00,
+    },
+    {   // '%'
+        0x46, 0x66, 0x30, 0x18, 0x0C, 0x66, 0x62, 0x00,
+    },
+    {   // 'I'
+        0x00, 0x41, 0x7F, 0x7F, 0x41, 0x00, 0x00, 0x00,
+    },
+    {   // 'n'
+        0x7C, 0x7C, 0x04, 0x04, 0x7C, 0x78, 0x00, 0x00,
+    },
+    {   // 'O'
+        0x1C, 0x3E, 0x63, 0x41, 0x63, 0x3E, 0x1C, 0x00,
+    },
+    {   // 'u'
+        0x3C, 0x7C, 0x40, 0x40, 0x3C, 0x7C, 0x40, 0x00,
+    },
+    {   // 't'
+        0x00, 0x04, 0x3E, 0x7F, 0x44, 0x24, 0x00, 0x00,
+    },
+    {   // 'T'
+        0x03, 0x41, 0x7F, 0x7F, 0x41, 0x03, 0x00, 0x00,
+    },
+    {   // 'H'
+        0x7F, 0x7F, 0x08, 0x08, 0x7F, 0x7F, 0x00, 0x00,
+    },
+    {   // degree mark
+        0x39, 0x7C, 0xC6, 0x82, 0x82, 0xC6, 0x44, 0x00,
+    },
+};
+
+const uint8_t glyph_table_scale2[][GLYPH_TABLE_SIZE(2)] = {
+    {   // '0'
+        0xFC, 0x0F, 0xFC, 0x0F, 0xFF, 0x3F, 0xFF, 0x3F, 0x03, 0x3F, 0x03, 0x3F,
+        0xC3, 0x33, 0xC3, 0x33, 0xF3, 0x30, 0xF3, 0x30, 0xFF, 0x3F, 0xFF, 0x3F,
+        0xFC, 0x0F, 0xFC, 0x0F, 0x00, 0x00, 0x00, 0x00,
+    },
+    {   // '1'
+        0x00, 0x30, 0x00, 0x30, 0x0C, 0x30, 0x0C, 0x30, 0xFF, 0x3F, 0xFF, 0x3F,
+        0xFF, 0x3F, 0xFF, 0x3F, 0x00, 0x30, 0x00, 0x30, 0x00, 0x30, 0x00, 0x30,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    },
+    {   // '2'
+        0x0C, 0x3C, 0x0C, 0x3C, 0x0F, 0x3F, 0x0F, 0x3F, 0xC3, 0x33, 0xC3, 0x33,
+        0xC3, 0x30, 0xC3, 0x30, 0xFF, 0x3C, 0xFF, 0x3C, 0x3C, 0x3C, 0x3C, 0x3C,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    },
+    {   // '3'
+        0x0C, 0x0C, 0x0C, 0x0C, 0x0F, 0x3C, 0x0F, 0x3C, 0xC3, 0x30, 0xC3, 0x30,
+        0xC3, 0x30, 0xC3, 0x30, 0xFF, 0x3F, 0xFF, 0x3F, 0x3C, 0x0F, 0x3C, 0x0F,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    },
+    {   // '4'
+        0xC0, 0x03, 0xC0, 0x03, 0xF0, 0x03, 0xF0, 0x03, 0x3C, 0x03, 0x3C, 0x03,
+        0x0F, 0x33, 0x0F, 0x33, 0xFF, 0x3F, 0xFF, 0x3F, 0xFF, 0x3F, 0xFF, 0x3F,
+        0x00, 0x33, 0x00, 0x33, 0x00, 0x00, 0x00, 0x00,
+    },
+    {   // '5'
+        0x3F, 0x0C, 0x3F, 0x0C, 0x3F, 0x3C, 0x3F, 0x3C, 0x33, 0x30, 0x33, 0x30,
+        0x33, 0x30, 0x33, 0x30, 0xF3, 0x3F, 0xF3, 0x3F, 0xC3, 0x0F, 0xC3, 0x0F,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    },
+    {   // '6'
+        0xF0, 0x0F, 0xF0, 0x0F, 0xFC, 0x3F, 0xFC, 0x3F, 0xCF, 0x30, 0xCF, 0x30,
+        0xC3, 0x30, 0xC3, 0x30, 0xC3, 0x3F, 0xC3, 0x3F, 0x00, 0x0F, 0x00, 0x0F,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    },
+    {   // '7'
+        0x0F, 0x00, 0x0F, 0x00, 0x0F, 0x00, 0x0F, 0x00, 0x03, 0x3F, 0x03, 0x3F,
+        0xC3, 0x3F, 0xC3, 0x3F, 0xFF, 0x00, 0xFF, 0x00, 0x3F, 0x00, 0x3F, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    },
+    {   // '8'
+        0x3C, 0x0F, 0x3C, 0x0F, 0xFF, 0x3F, 0xFF, 0x3F, 0xC3, 0x30, 0xC3, 0x30,
+        0xC3, 0x30, 0xC3, 0x30, 0xFF, 0x3F, 0xFF, 0x3F, 0x3C, 0x0F, 0x3C, 0x0F,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    },
+    {   // '9'
+        0x3C, 0x00, 0x3C, 0x00, 0xFF, 0x30, 0xFF, 0x30, 0xC3, 0x30, 0xC3, 0x30,
+        0xC3, 0x3C, 0xC3, 0x3C, 0xFF, 0x0F, 0xFF, 0x0F, 0xFC, 0x03, 0xFC, 0x03,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    },
+    {   // '-'
+        0xC0, 0x00, 0xC0, 0x00, 0xC0, 0x00, 0xC0, 0x00, 0xC0, 0x00, 0xC0, 0x00,
+        0xC0, 0x00, 0xC0, 0x00, 0xC0, 0x00, 0xC0, 0x00, 0xC0, 0x00, 0xC0, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    },
+    {   // '.'
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x3C, 0x00, 0x3C,
+        0x00, 0x3C, 0x00, 0x3C, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    },
+    {   // '%'
+        0x3C, 0x30, 0x3C, 0x30, 0x3C, 0x3C, 0x3C, 0x3C, 0x00, 0x0F, 0x00, 0x0F,
+        0xC0, 0x03, 0xC0, 0x03, 0xF0, 0x00, 0xF0, 0x00, 0x3C, 0x3C, 0x3C, 0x3C,
+        0x0C, 0x3C, 0x0C, 0x3C, 0x00, 0x00, 0x00, 0x00,
+    },
+    {   // 'I'
+        0x00, 0x00, 0x00, 0x00, 0x03, 0x30, 0x03, 0x30, 0xFF, 0x3F, 0xFF, 0x3F,
+        0xFF, 0x3F, 0xFF, 0x3F, 0x03, 0x30, 0x03, 0x30, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    },
+    {   // 'n'
+        0xF0, 0x3F, 0xF0, 0x3F, 0xF0, 0x3F, 0xF0, 0x3F, 0x30, 0x00, 0x30, 0x00,
+        0x30, 0x00, 0x30, 0x00, 0xF0, 0x3F, 0xF0, 0x3F, 0xC0, 0x3F, 0xC0, 0x3F,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    },
+    {   // 'O'
+        0xF0, 0x03, 0xF0, 0x03, 0xFC, 0x0F, 0xFC, 0x0F, 0x0F, 0x3C, 0x0F, 0x3C,
+        0x03, 0x30, 0x03, 0x30, 0x0F, 0x3C, 0x0F, 0x3C, 0xFC, 0x0F, 0xFC, 0x0F,
+        0xF0, 0x03, 0xF0, 0x03, 0x00, 0x00, 0x00, 0x00,
+    },
+    {   // 'u'
+        0xF0, 0x0F, 0xF0, 0x0F, 0xF0, 0x3F, 0xF0, 0x3F, 0x00, 0x30, 0x00, 0x30,
+        0x00, 0x30, 0x00, 0x30, 0xF0, 0x0F, 0xF0, 0x0F, 0xF0, 0x3F, 0xF0, 0x3F,
+        0x00, 0x30, 0x00, 0x30, 0x00, 0x00, 0x00, 0x00,
+    },
+    {   // 't'
+        0x00, 0x00, 0x00, 0x00, 0x30, 0x00, 0x30, 0x00, 0xFC, 0x0F, 0xFC, 0x0F,
+        0xFF, 0x3F, 0xFF, 0x3F, 0x30, 0x30, 0x30, 0x30, 0x30, 0x0C, 0x30, 0x0C,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    },
+    {   // 'T'
+        0x0F, 0x00, 0x0F, 0x00, 0x03, 0x30, 0x03, 0x30, 0xFF, 0x3F, 0xFF, 0x3F,
+        0xFF, 0x3F, 0xFF, 0x3F, 0x03, 0x30, 0x03, 0x30, 0x0F, 0x00, 0x0F, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    },
+    {   // 'H'
+        0xFF, 0x3F, 0xFF, 0x3F, 0xFF, 0x3F, 0xFF, 0x3F, 0xC0, 0x00, 0xC0, 0x00,
+        0xC0, 0x00, 0xC0, 0x00, 0xFF, 0x3F, 0xFF, 0x3F, 0xFF, 0x3F, 0xFF, 0x3F,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    },
+    {   // degree mark
+        0xC3, 0x0F, 0xC3, 0x0F, 0xF0, 0x3F, 0xF0, 0x3F, 0x3C, 0xF0, 0x3C, 0xF0,
+        0x0C, 0xC0, 0x0C, 0xC0, 0x0C, 0xC0, 0x0C, 0xC0, 0x3C, 0xF0, 0x3C, 0xF0,
+        0x30, 0x30, 0x30, 0x30, 0x00, 0x00, 0x00, 0x00,
+    },
+};
+
+const uint8_t glyph_table_scale3[][GLYPH_TABLE_SIZE(3)] = {
+    {   // '0'
+        0xF8, 0xFF, 0x03, 0xF8, 0xFF, 0x03, 0xF8, 0xFF, 0x03, 0xFF, 0xFF, 0x1F,
+        0xFF, 0xFF, 0x1F, 0xFF, 0xFF, 0x1F, 0x07, 0xF0, 0x1F, 0x07, 0xF0, 0x1F,
+        0x07, 0xF0, 0x1F, 0x07, 0x7E, 0x1C, 0x07, 0x7E, 0x1C, 0x07, 0x7E, 0x1C,
+        0xC7, 0x0F, 0x1C, 0xC7, 0x0F, 0x1C, 0xC7, 0x0F, 0x1C, 0xFF, 0xFF, 0x1F,
+        0xFF, 0xFF, 0x1F, 0xFF, 0xFF, 0x1F, 0xF8, 0xFF, 0x03, 0xF8, 0xFF, 0x03,
+        0xF8, 0xFF, 0x03, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    },
+    {   // '1'
+        0x00, 0x00, 0x1C, 0x00, 0x00, 0x1C, 0x00, 0x00, 0x1C, 0x38, 0x00, 0x1C,
+        0x38, 0x00, 0x1C, 0x38, 0x00, 0x1C, 0xFF, 0xFF, 0x1F, 0xFF, 0xFF, 0x1F,
+        0xFF, 0xFF, 0x1F, 0xFF, 0xFF, 0x1F, 0xFF, 0xFF, 0x1F, 0xFF, 0xFF, 0x1F,
+        0x00, 0x00, 0x1C, 0x00, 0x00, 0x1C, 0x00, 0x00, 0x1C, 0x00, 0x00, 0x1C,
+        0x00, 0x00, 0x1C, 0x00, 0x00, 0x1C, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    },
+    {   // '2'
+        0x38, 0x80, 0x1F, 0x38, 0x80, 0x1F, 0x38, 0x80, 0x1F, 0x3F, 0xF0, 0x1F,
+        0x3F, 0xF0, 0x1F, 0x3F, 0xF0, 0x1F, 0x07, 0x7E, 0x1C, 0x07, 0x7E, 0x1C,
+        0x07, 0x7E, 0x1C, 0x07, 0x0E, 0x1C, 0x07, 0x0E, 0x1C, 0x07, 0x0E, 0x1C,
+        0xFF, 0x8F, 0x1F, 0xFF, 0x8F, 0x1F, 0xFF, 0x8F, 0x1F, 0xF8, 0x81, 0x1F,
+        0xF8, 0x81, 0x1F, 0xF8, 0x81, 0x1F, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    },
+    {   // '3'
+        0x38, 0x80, 0x03, 0x38, 0x80, 0x03, 0x38, 0x80, 0x03, 0x3F, 0x80, 0x1F,
+        0x3F, 0x80, 0x1F, 0x3F, 0x80, 0x1F, 0x07, 0x0E, 0x1C, 0x07, 0x0E, 0x1C,
+        0x07, 0x0E, 0x1C, 0x07, 0x0E, 0x1C, 0x07, 0x0E, 0x1C, 0x07, 0x0E, 0x1C,
+        0xFF, 0xFF, 0x1F, 0xFF, 0xFF, 0x1F, 0xFF, 0xFF, 0x1F, 0xF8, 0xF1, 0x03,
+        0xF8, 0xF1, 0x03, 0xF8, 0xF1, 0x03, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    },
+    {   // '4'
+        0x00, 0x7E, 0x00, 0x00, 0x7E, 0x00, 0x00, 0x7E, 0x00, 0xC0, 0x7F, 0x00,
+        0xC0, 0x7F, 0x00, 0xC0, 0x7F, 0x00, 0xF8, 0x71, 0x00, 0xF8, 0x71, 0x00,
+        0xF8, 0x71, 0x00, 0x3F, 0x70, 0x1C, 0x3F, 0x70, 0x1C, 0x3F, 0x70, 0x1C,
+        0xFF, 0xFF, 0x1F, 0xFF, 0xFF, 0x1F, 0xFF, 0xFF, 0x1F, 0xFF, 0xFF, 0x1F,
+        0xFF, 0xFF, 0x1F, 0xFF, 0xFF, 0x1F, 0x00, 0x70, 0x1C, 0x00, 0x70, 0x1C,
+        0x00, 0x70, 0x1C, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    },
+    {   // '5'
+        0xFF, 0x81, 0x03, 0xFF, 0x81, 0x03, 0xFF, 0x81, 0x03, 0xFF, 0x81, 0x1F,
+        0xFF, 0x81, 0x1F, 0xFF, 0x81, 0x1F, 0xC7, 0x01, 0x1C, 0xC7, 0x01, 0x1C,
+        0xC7, 0x01, 0x1C, 0xC7, 0x01, 0x1C, 0xC7, 0x01, 0x1C, 0xC7, 0x01, 0x1C,
+        0xC7, 0xFF, 0x1F, 0xC7, 0xFF, 0x1F, 0xC7, 0xFF, 0x1F, 0x07, 0xFE, 0x03,
+        0x07, 0xFE, 0x03, 0x07, 0xFE, 0x03, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    },
+    {   // '6'
+        0xC0, 0xFF, 0x03, 0xC0, 0xFF, 0x03, 0xC0, 0xFF, 0x03, 0xF8, 0xFF, 0x1F,
+        0xF8, 0xFF, 0x1F, 0xF8, 0xFF, 0x1F, 0x3F, 0x0E, 0x1C, 0x3F, 0x0E, 0x1C,
+        0x3F, 0x0E, 0x1C, 0x07, 0x0E, 0x1C, 0x07, 0x0E, 0x1C, 0x07, 0x0E, 0x1C,
+        0x07, 0xFE, 0x1F, 0x07, 0xFE, 0x1F, 0x07, 0xFE, 0x1F, 0x00, 0xF0, 0x03,
+        0x00, 0xF0, 0x03, 0x00, 0xF0, 0x03, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    },
+    {   // '7'
+        0x3F, 0x00, 0x00, 0x3F, 0x00, 0x00, 0x3F, 0x00, 0x00, 0x3F, 0x00, 0x00,
+        0x3F, 0x00, 0x00, 0x3F, 0x00, 0x00, 0x07, 0xF0, 0x1F, 0x07, 0xF0, 0x1F,
+        0x07, 0xF0, 0x1F, 0x07, 0xFE, 0x1F, 0x07, 0xFE, 0x1F, 0x07, 0xFE, 0x1F,
+        0xFF, 0x0F, 0x00, 0xFF, 0x0F, 0x00, 0xFF, 0x0F, 0x00, 0xFF, 0x01, 0x00,
+        0xFF, 0x01, 0x00, 0xFF, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    },
+    {   // '8'
+        0xF8, 0xF1, 0x03, 0xF8, 0xF1, 0x03, 0xF8, 0xF1, 0x03, 0xFF, 0xFF, 0x1F,
+        0xFF, 0xFF, 0x1F, 0xFF, 0xFF, 0x1F, 0x07, 0x0E, 0x1C, 0x07, 0x0E, 0x1C,
+        0x07, 0x0E, 0x1C, 0x07, 0x0E, 0x1C, 0x07, 0x0E, 0x1C, 0x07, 0x0E, 0x1C,
+        0xFF, 0xFF, 0x1F, 0xFF, 0xFF, 0x1F, 0xFF, 0xFF, 0x1F, 0xF8, 0xF1, 0x03,
+        0xF8, 0xF1, 0x03, 0xF8, 0xF1, 0x03, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    },
+    {   // '9'
+        0xF8, 0x01, 0x00, 0xF8, 0x01, 0x00, 0xF8, 0x01, 0x00, 0xFF, 0x0F, 0x1C,
+        0xFF, 0x0F, 0x1C, 0xFF, 0x0F, 0x1C, 0x07, 0x0E, 0x1C, 0x07, 0x0E, 0x1C,
+        0x07, 0x0E, 0x1C, 0x07, 0x8E, 0x1F, 0x07, 0x8E, 0x1F, 0x07, 0x8E, 0x1F,
+        0xFF, 0xFF, 0x03, 0xFF, 0xFF, 0x03, 0xFF, 0xFF, 0x03, 0xF8, 0x7F, 0x00,
+        0xF8, 0x7F, 0x00, 0xF8, 0x7F, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    },
+    {   // '-'
+        0x00, 0x0E, 0x00, 0x00, 0x0E, 0x00, 0x00, 0x0E, 0x00, 0x00, 0x0E, 0x00,
+        0x00, 0x0E, 0x00, 0x00, 0x0E, 0x00, 0x00, 0x0E, 0x00, 0x00, 0x0E, 0x00,
+        0x00, 0x0E, 0x00, 0x00, 0x0E, 0x00, 0x00, 0x0E, 0x00, 0x00, 0x0E, 0x00,
+        0x00, 0x0E, 0x00, 0x00, 0x0E, 0x00, 0x00, 0x0E, 0x00, 0x00, 0x0E, 0x00,
+        0x00, 0x0E, 0x00, 0x00, 0x0E, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    },
+    {   // '.'
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80, 0x1F, 0x00, 0x80, 0x1F,
+        0x00, 0x80, 0x1F, 0x00, 0x80, 0x1F, 0x00, 0x80, 0x1F, 0x00, 0x80, 0x1F,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    },
+    {   // '%'
+        0xF8, 0x01, 0x1C, 0xF8, 0x01, 0x1C, 0xF8, 0x01, 0x1C, 0xF8, 0x81, 0x1F,
+        0xF8, 0x81, 0x1F, 0xF8, 0x81, 0x1F, 0x00, 0xF0, 0x03, 0x00, 0xF0, 0x03,
+        0x00, 0xF0, 0x03, 0x00, 0x7E, 0x00, 0x00, 0x7E, 0x00, 0x00, 0x7E, 0x00,
+        0xC0, 0x0F, 0x00, 0xC0, 0x0F, 0x00, 0xC0, 0x0F, 0x00, 0xF8, 0x81, 0x1F,
+        0xF8, 0x81, 0x1F, 0xF8, 0x81, 0x1F, 0x38, 0x80, 0x1F, 0x38, 0x80, 0x1F,
+        0x38, 0x80, 0x1F, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    },
+    {   // 'I'
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x07, 0x00, 0x1C,
+        0x07, 0x00, 0x1C, 0x07, 0x00, 0x1C, 0xFF, 0xFF, 0x1F, 0xFF, 0xFF, 0x1F,
+        0xFF, 0xFF, 0x1F, 0xFF, 0xFF, 0x1F, 0xFF, 0xFF, 0x1F, 0xFF, 0xFF, 0x1F,
+        0x07, 0x00, 0x1C, 0x07, 0x00, 0x1C, 0x07, 0x00, 0x1C, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    },
+    {   // 'n'
+        0xC0, 0xFF, 0x1F, 0xC0, 0xFF, 0x1F, 0xC0, 0xFF, 0x1F, 0xC0, 0xFF, 0x1F,
+        0xC0, 0xFF, 0x1F, 0xC0, 0xFF, 0x1F, 0xC0, 0x01, 0x00, 0xC0, 0x01, 0x00,
+        0xC0, 0x01, 0x00, 0xC0, 0x01, 0x00, 0xC0, 0x01, 0x00, 0xC0, 0x01, 0x00,
+        0xC0, 0xFF, 0x1F, 0xC0, 0xFF, 0x1F, 0xC0, 0xFF, 0x1F, 0x00, 0xFE, 0x1F,
+        0x00, 0xFE, 0x1F, 0x00, 0xFE, 0x1F, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    },
+    {   // 'O'
+        0xC0, 0x7F, 0x00, 0xC0, 0x7F, 0x00, 0xC0, 0x7F, 0x00, 0xF8, 0xFF, 0x03,
+        0xF8, 0xFF, 0x03, 0xF8, 0xFF, 0x03, 0x3F, 0x80, 0x1F, 0x3F, 0x80, 0x1F,
+        0x3F, 0x80, 0x1F, 0x07, 0x00, 0x1C, 0x07, 0x00, 0x1C, 0x07, 0x00, 0x1C,
+        0x3F, 0x80, 0x1F, 0x3F, 0x80, 0x1F, 0x3F, 0x80, 0x1F, 0xF8, 0xFF, 0x03,
+        0xF8, 0xFF, 0x03, 0xF8, 0xFF, 0x03, 0xC0, 0x7F, 0x00, 0xC0, 0x7F, 0x00,
+        0xC0, 0x7F, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    },
+    {   // 'u'
+        0xC0, 0xFF, 0x03, 0xC0, 0xFF, 0x03, 0xC0, 0xFF, 0x03, 0xC0, 0xFF, 0x1F,
+        0xC0, 0xFF, 0x1F, 0xC0, 0xFF, 0x1F, 0x00, 0x00, 0x1C, 0x00, 0x00, 0x1C,
+        0x00, 0x00, 0x1C, 0x00, 0x00, 0x1C, 0x00, 0x00, 0x1C, 0x00, 0x00, 0x1C,
+        0xC0, 0xFF, 0x03, 0xC0, 0xFF, 0x03, 0xC0, 0xFF, 0x03, 0xC0, 0xFF, 0x1F,
+        0xC0, 0xFF, 0x1F, 0xC0, 0xFF, 0x1F, 0x00, 0x00, 0x1C, 0x00, 0x00, 0x1C,
+        0x00, 0x00, 0x1C, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    },
+    {   // 't'
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xC0, 0x01, 0x00,
+        0xC0, 0x01, 0x00, 0xC0, 0x01, 0x00, 0xF8, 0xFF, 0x03, 0xF8, 0xFF, 0x03,
+        0xF8, 0xFF, 0x03, 0xFF, 0xFF, 0x1F, 0xFF, 0xFF, 0x1F, 0xFF, 0xFF, 0x1F,
+        0xC0, 0x01, 0x1C, 0xC0, 0x01, 0x1C, 0xC0, 0x01, 0x1C, 0xC0, 0x81, 0x03,
+        0xC0, 0x81, 0x03, 0xC0, 0x81, 0x03, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    },
+    {   // 'T'
+        0x3F, 0x00, 0x00, 0x3F, 0x00, 0x00, 0x3F, 0x00, 0x00, 0x07, 0x00, 0x1C,
+        0x07, 0x00, 0x1C, 0x07, 0x00, 0x1C, 0xFF, 0xFF, 0x1F, 0xFF, 0xFF, 0x1F,
+        0xFF, 0xFF, 0x1F, 0xFF, 0xFF, 0x1F, 0xFF, 0xFF, 0x1F, 0xFF, 0xFF, 0x1F,
+        0x07, 0x00, 0x1C, 0x07, 0x00, 0x1C, 0x07, 0x00, 0x1C, 0x3F, 0x00, 0x00,
+        0x3F, 0x00, 0x00, 0x3F, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    },
+    {   // 'H'
+        0xFF, 0xFF, 0x1F, 0xFF, 0xFF, 0x1F, 0xFF, 0xFF, 0x1F, 0xFF, 0xFF, 0x1F,
+        0xFF, 0xFF, 0x1F, 0xFF, 0xFF, 0x1F, 0x00, 0x0E, 0x00, 0x00, 0x0E, 0x00,
+        0x00, 0x0E, 0x00, 0x00, 0x0E, 0x00, 0x00, 0x0E, 0x00, 0x00, 0x0E, 0x00,
+        0xFF, 0xFF, 0x1F, 0xFF, 0xFF, 0x1F, 0xFF, 0xFF, 0x1F, 0xFF, 0xFF, 0x1F,
+        0xFF, 0xFF, 0x1F, 0xFF, 0xFF, 0x1F, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    },
+    {   // degree mark
+        0x07, 0xFE, 0x03, 0x07, 0xFE, 0x03, 0x07, 0xFE, 0x03, 0xC0, 0xFF, 0x1F,
+        0xC0, 0xFF, 0x1F, 0xC0, 0xFF, 0x1F, 0xF8, 0x01, 0xFC, 0xF8, 0x01, 0xFC,
+        0xF8, 0x01, 0xFC, 0x38, 0x00, 0xE0, 0x38, 0x00, 0xE0, 0x38, 0x00, 0xE0,
+        0x38, 0x00, 0xE0, 0x38, 0x00, 0xE0, 0x38, 0x00, 0xE0, 0xF8, 0x01, 0xFC,
+        0xF8, 0x01, 0xFC, 0xF8, 0x01, 0xFC, 0xC0, 0x01, 0x1C, 0xC0, 0x01, 0x1C,
+        0xC0, 0x01, 0x1C, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    },
+};
@@ -0,0 +1,53 @@
+#ifndef _GLYPH_TABLE_H_
+#define _GLYPH_TABLE_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "font.h"
+
+
+// Glyphs that are pre-scaled at build time by tools/gen_glyph_table.py, stored in flash.
+// Each glyph is packed with 1 bit per pixel, in the order the display expects the pixels:
+// x first, then y, least significant bit first. Only the characters the UI uses are included.
+
+// Set to 0 to always scale at runtime, used to compare the two
+#ifndef GLYPH_TABLE_ENABLED
+#define GLYPH_TABLE_ENABLED     1
+#endif
+
+#define GLYPH_TABLE_MAX_SCALE   3
+
+// Bytes in a packed glyph of a certain scale
+#define GLYPH_TABLE_SIZE(scale) (FONT_NUM_ROWS * FONT_NUM_ROWS * (scale) * (scale) / 8)
+
+
+// Index of a character in the tables below, -1 if it is not included
+extern const int8_t glyph_table_index[FONT_MAX_CHAR];
+
+extern const uint8_t glyph_table_scale1[][GLYPH_TABLE_SIZE(1)];
+extern const uint8_t glyph_table_scale2[][GLYPH_TABLE_SIZE(2)];
+extern const uint8_t glyph_table_scale3[][GLYPH_TABLE_SIZE(3)];
+
+
+// Returns the packed glyph, or NULL if the character or scale is not in the tables
+static inline const uint8_t * glyph_table_get(const char character, const size_t scale) {
+    const int8_t index = glyph_table_index[(uint8_t)character];
+
+    if(!GLYPH_TABLE_ENABLED || index < 0)
+        return NULL;
+
+    switch(scale) {
+    case 1:
+        return glyph_table_scale1[index];
+    case 2:
+        return glyph_table_scale2[index];
+    case 3:
+        return glyph_table_scale3[index];
+    default:
+        return NULL;
+    }
+}
+
+
+#endif//_GLYPH_TABLE_H_
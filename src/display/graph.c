@@ -0,0 +1,97 @@
+#include "graph.h"
+
+#include <string.h>
+
+#include "nrf_assert.h"
+
+#include "log.h"
+
+
+
+// One line of the graph, at most the width of the display
+static pixel_t line_buffer[DISPLAY_WIDTH];
+
+
+static inline uint8_t value_to_x(const graph_t * const graph, const int16_t value);
+
+
+
+// Position of a value in the line, relative to the area
+static inline uint8_t value_to_x(const graph_t * const graph, const int16_t value) {
+    const int16_t clipped = value < graph->min ? graph->min : (value > graph->max ? graph->max : value);
+
+    return ((int32_t)(graph->max - clipped) * (graph->area.x_len - 1)) / (graph->max - graph->min);
+}
+
+
+void graph_init(graph_t * const graph, const rect_t * const area, const int16_t min, const int16_t max, const pixel_t * const background) {
+    NRFX_ASSERT(graph != NULL);
+    NRFX_ASSERT(area != NULL);
+    NRFX_ASSERT(background != NULL);
+    NRFX_ASSERT(min < max);
+
+    memset(graph, 0x00, sizeof(*graph));
+    graph->area = *area;
+    graph->min = min;
+    graph->max = max;
+    graph->background = *background;
+
+    // The display can only scroll whole lines
+    graph->hardware_scroll = area->x == 0 && area->x_len == DISPLAY_WIDTH;
+
+    ST7735_set_bounds(area->x, area->y, area->x_len, area->y_len);
+    ST7735_fill_bounds(background);
+
+    if(graph->hardware_scroll) {
+        ST7735_set_scroll_area(area->y, area->y_len);
+        ST7735_set_scroll_start(area->y);
+    }
+}
+
+
+void graph_add_series(graph_t * const graph, const pixel_t * const color) {
+    NRFX_ASSERT(graph != NULL);
+    NRFX_ASSERT(color != NULL);
+    NRFX_ASSERT(graph->num_series < GRAPH_MAX_SERIES);
+
+    graph->colors[graph->num_series++] = *color;
+}
+
+
+void graph_add_sample(graph_t * const graph, const int16_t * const values) {
+    NRFX_ASSERT(graph != NULL);
+    NRFX_ASSERT(values != NULL);
+
+    const uint8_t len = graph->area.x_len;
+
+    for(uint8_t i = 0; i < len; i++) {
+        line_buffer[i] = graph->background;
+    }
+
+    // Connect every sample to the previous one with a vertical line, such that steps are visible
+    for(uint8_t s = 0; s < graph->num_series; s++) {
+        const uint8_t x = value_to_x(graph, values[s]);
+        const uint8_t last = graph->has_samples ? graph->last[s] : x;
+        const uint8_t xs = x < last ? x : last;
+        const uint8_t xe = x < last ? last : x;
+
+        for(uint8_t i = xs; i <= xe; i++) {
+            line_buffer[i] = graph->colors[s];
+        }
+
+        graph->last[s] = x;
+    }
+
+    graph->has_samples = true;
+
+    // Overwrite the oldest line
+    ST7735_set_bounds(graph->area.x, graph->area.y + graph->line, len, 1);
+    ST7735_write_start();
+    ST7735_write_pixels(line_buffer, len);
+
+    graph->line = (graph->line + 1) % graph->area.y_len;
+
+    // Start showing from the line after the newest, which is the oldest, so the newest ends up on the right
+    if(graph->hardware_scroll)
+        ST7735_set_scroll_start(graph->area.y + graph->line);
+}
@@ -0,0 +1,44 @@
+#ifndef _GRAPH_H_
+#define _GRAPH_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "ST7735.h"
+#include "compositor.h"
+
+
+// History graph, time runs along y (left to right) and the value along x (high values at the top).
+// Adding a sample only sends one line (a single y) of the graph, whatever its size.
+// When the graph covers the full width of the display, the display scrolls it in hardware
+// and the newest sample is always on the right. Otherwise the samples sweep from left to right
+// and wrap around, overwriting the oldest one.
+
+
+#define GRAPH_MAX_SERIES    2
+
+
+typedef struct _graph {
+    rect_t area;
+    int16_t min;                            // Value at the bottom of the graph
+    int16_t max;                            // Value at the top of the graph
+    pixel_t background;
+    pixel_t colors[GRAPH_MAX_SERIES];
+    uint8_t num_series;
+    uint8_t last[GRAPH_MAX_SERIES];         // x of the previous sample, to connect the samples
+    uint8_t line;                           // Line (relative to the area) the next sample is drawn in
+    bool has_samples;
+    bool hardware_scroll;
+} graph_t;
+
+
+// Clears the area, values outside of min - max are clipped
+void graph_init(graph_t * const graph, const rect_t * const area, const int16_t min, const int16_t max, const pixel_t * const background);
+
+void graph_add_series(graph_t * const graph, const pixel_t * const color);
+
+// Add one value for every series
+void graph_add_sample(graph_t * const graph, const int16_t * const values);
+
+
+#endif//_GRAPH_H_
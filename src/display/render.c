@@ -0,0 +1,83 @@
+#include "render.h"
+
+#include <stddef.h>
+
+#include "nrf_assert.h"
+
+#include "log.h"
+#include "perf.h"
+
+
+typedef struct _render_entry {
+    render_job_t job;
+    void * context;
+} render_entry_t;
+
+
+// Ring buffer, jobs are taken from head
+static render_entry_t queue[RENDER_QUEUE_SIZE];
+static size_t head = 0;
+static size_t num_queued = 0;
+
+static render_stats_t stats = {0};
+
+
+
+void render_push(const render_job_t job, void * const context) {
+    NRFX_ASSERT(job != NULL);
+    NRFX_ASSERT(num_queued < RENDER_QUEUE_SIZE);
+
+    queue[(head + num_queued) % RENDER_QUEUE_SIZE] = (render_entry_t) { .job = job, .context = context };
+    num_queued++;
+
+    if(num_queued > stats.max_queued)
+        stats.max_queued = num_queued;
+}
+
+
+bool render_run() {
+    if(num_queued == 0)
+        return false;
+
+    const uint32_t start = perf_ticks();
+    uint32_t elapsed = 0;
+    uint8_t jobs = 0;
+
+    // A job can push new jobs, those run in a later pass at the earliest if the budget is used up
+    while(num_queued > 0 && jobs < RENDER_MAX_JOBS && elapsed < RENDER_BUDGET_US) {
+        const render_entry_t entry = queue[head];
+
+        jobs++;
+
+        // Not done, it stays at the head of the queue
+        if(entry.job(entry.context)) {
+            head = (head + 1) % RENDER_QUEUE_SIZE;
+            num_queued--;
+        }
+
+        elapsed = perf_ticks_to_us(start, perf_ticks());
+    }
+
+    stats.passes++;
+    stats.jobs += jobs;
+
+    if(elapsed > stats.max_pass_us)
+        stats.max_pass_us = elapsed;
+
+    return num_queued > 0;
+}
+
+
+bool render_busy() {
+    return num_queued > 0;
+}
+
+
+const render_stats_t * render_get_stats() {
+    return &stats;
+}
+
+
+void render_reset_stats() {
+    stats = (render_stats_t) {0};
+}
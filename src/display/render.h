@@ -0,0 +1,45 @@
+#ifndef _RENDER_H_
+#define _RENDER_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+
+// Cooperative render queue.
+// Drawing is split into small jobs (one glyph, one fill, one rect of the compositor...),
+// the main loop runs a few of them per pass until the time budget is used up.
+// This keeps the time between two passes of the main loop bounded, whatever is being drawn.
+
+
+#define RENDER_QUEUE_SIZE       32
+
+// A pass stops starting new jobs after this much (wall) time, or this many jobs
+#define RENDER_BUDGET_US        2000
+#define RENDER_MAX_JOBS         8
+
+
+// Returns true when the job is done, false to be called again in a later pass
+typedef bool (*render_job_t)(void * context);
+
+typedef struct _render_stats {
+    uint32_t passes;            // Passes that ran at least one job
+    uint32_t jobs;              // Job calls
+    uint32_t max_pass_us;       // Longest pass, the worst case latency the queue adds to the main loop
+    uint16_t max_queued;        // Most jobs in the queue at once
+} render_stats_t;
+
+
+// Add a job to the end of the queue, jobs run in order
+void render_push(const render_job_t job, void * const context);
+
+// Run jobs until the budget is used up. Always runs at least one job if there is one.
+// Returns true when there are jobs left
+bool render_run();
+
+bool render_busy();
+
+const render_stats_t * render_get_stats();
+void render_reset_stats();
+
+
+#endif//_RENDER_H_
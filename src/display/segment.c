@@ -0,0 +1,213 @@
+#include "segment.h"
+
+#include <string.h>
+
+#include "nrf_assert.h"
+
+#include "font.h"
+#include "compositor.h"
+#include "log.h"
+
+
+// Bytes needed to set the bounds and start writing: CASET, RASET (each with 4 parameters) and RAMWR
+#define FILL_COMMAND_BYTES  11
+
+#define SEGMENT_A   (1 << 0)
+#define SEGMENT_B   (1 << 1)
+#define SEGMENT_C   (1 << 2)
+#define SEGMENT_D   (1 << 3)
+#define SEGMENT_E   (1 << 4)
+#define SEGMENT_F   (1 << 5)
+#define SEGMENT_G   (1 << 6)
+#define NUM_SEGMENTS    7
+
+
+
+// Position of every segment in a digit, in units of the scale.
+// The display is rotated, so x is from top to bottom and y from left to right.
+// Like the font, a digit is 6 wide and 7 high with a border on the left
+static const rect_t segments[NUM_SEGMENTS] = {
+    { .x = 0, .y = 1, .x_len = 1, .y_len = 6 },     // A, top
+    { .x = 0, .y = 6, .x_len = 4, .y_len = 1 },     // B, top right
+    { .x = 3, .y = 6, .x_len = 4, .y_len = 1 },     // C, bottom right
+    { .x = 6, .y = 1, .x_len = 1, .y_len = 6 },     // D, bottom
+    { .x = 3, .y = 1, .x_len = 4, .y_len = 1 },     // E, bottom left
+    { .x = 0, .y = 1, .x_len = 4, .y_len = 1 },     // F, top left
+    { .x = 3, .y = 1, .x_len = 1, .y_len = 6 },     // G, middle
+};
+
+static const uint8_t digits[10] = {
+    SEGMENT_A | SEGMENT_B | SEGMENT_C | SEGMENT_D | SEGMENT_E | SEGMENT_F,              // 0
+    SEGMENT_B | SEGMENT_C,                                                              // 1
+    SEGMENT_A | SEGMENT_B | SEGMENT_D | SEGMENT_E | SEGMENT_G,                          // 2
+    SEGMENT_A | SEGMENT_B | SEGMENT_C | SEGMENT_D | SEGMENT_G,                          // 3
+    SEGMENT_B | SEGMENT_C | SEGMENT_F | SEGMENT_G,                                      // 4
+    SEGMENT_A | SEGMENT_C | SEGMENT_D | SEGMENT_F | SEGMENT_G,                          // 5
+    SEGMENT_A | SEGMENT_C | SEGMENT_D | SEGMENT_E | SEGMENT_F | SEGMENT_G,              // 6
+    SEGMENT_A | SEGMENT_B | SEGMENT_C,                                                  // 7
+    SEGMENT_A | SEGMENT_B | SEGMENT_C | SEGMENT_D | SEGMENT_E | SEGMENT_F | SEGMENT_G,  // 8
+    SEGMENT_A | SEGMENT_B | SEGMENT_C | SEGMENT_D | SEGMENT_F | SEGMENT_G,              // 9
+};
+
+static segment_stats_t stats = {0};
+
+
+static inline uint8_t character_segments(const char character);
+static inline rect_t digit_rect(const segment_display_t * const display, const uint8_t digit);
+static uint8_t touching_segments(const uint8_t mask);
+static void fill_segments(const segment_display_t * const display, const uint8_t digit, const uint8_t mask, const pixel_t * const color);
+
+
+
+static inline uint8_t character_segments(const char character) {
+    if(character >= '0' && character <= '9')
+        return digits[character - '0'];
+
+    NRFX_ASSERT(character == '-');
+    return SEGMENT_G;
+}
+
+
+static inline rect_t digit_rect(const segment_display_t * const display, const uint8_t digit) {
+    const uint8_t len = FONT_NUM_ROWS * display->scale;
+
+    return (rect_t) { .x = display->x, .y = display->y + digit * len, .x_len = len, .y_len = len };
+}
+
+
+// The segments share their corners, every segment that overlaps one in the mask
+static uint8_t touching_segments(const uint8_t mask) {
+    uint8_t touching = 0;
+
+    for(uint8_t i = 0; i < NUM_SEGMENTS; i++) {
+        if(!(mask & (1 << i)))
+            continue;
+
+        const rect_t * const a = &segments[i];
+
+        for(uint8_t j = 0; j < NUM_SEGMENTS; j++) {
+            const rect_t * const b = &segments[j];
+
+            if(a->x < b->x + b->x_len && b->x < a->x + a->x_len &&
+               a->y < b->y + b->y_len && b->y < a->y + a->y_len)
+                touching |= 1 << j;
+        }
+    }
+
+    return touching;
+}
+
+
+// Fill every segment in the mask with a color, one window per segment
+static void fill_segments(const segment_display_t * const display, const uint8_t digit, const uint8_t mask, const pixel_t * const color) {
+    const rect_t cell = digit_rect(display, digit);
+    const uint8_t scale = display->scale;
+
+    for(uint8_t i = 0; i < NUM_SEGMENTS; i++) {
+        if(!(mask & (1 << i)))
+            continue;
+
+        const rect_t * const segment = &segments[i];
+
+        ST7735_set_bounds(cell.x + segment->x * scale, cell.y + segment->y * scale,
+                          segment->x_len * scale, segment->y_len * scale);
+        ST7735_fill_bounds(color);
+
+        stats.bytes += FILL_COMMAND_BYTES + segment->x_len * segment->y_len * scale * scale * sizeof(pixel_t);
+    }
+}
+
+
+void segment_display_init(  segment_display_t * const display,
+                            const uint8_t x,
+                            const uint8_t y,
+                            const uint8_t scale,
+                            const pixel_t * const color,
+                            const pixel_t * const background) {
+    NRFX_ASSERT(display != NULL);
+    NRFX_ASSERT(color != NULL);
+    NRFX_ASSERT(background != NULL);
+    NRFX_ASSERT(scale > 0);
+
+    memset(display, 0x00, sizeof(*display));
+    display->x = x;
+    display->y = y;
+    display->scale = scale;
+    display->color = *color;
+    display->background = *background;
+}
+
+
+void segment_display_set_scale(segment_display_t * const display, const uint8_t scale) {
+    NRFX_ASSERT(display != NULL);
+    NRFX_ASSERT(scale > 0);
+
+    if(scale == display->scale)
+        return;
+
+    for(uint8_t i = 0; i < display->num_digits; i++) {
+        fill_segments(display, i, display->lit[i], &display->background);
+        display->lit[i] = 0;
+    }
+
+    display->scale = scale;
+}
+
+
+void segment_display_set(segment_display_t * const display, const char * const text) {
+    NRFX_ASSERT(display != NULL);
+    NRFX_ASSERT(text != NULL);
+
+    const size_t len = strlen(text);
+    const uint8_t num_cells = display->num_digits > len ? display->num_digits : len;
+    const uint8_t len_glyph = FONT_NUM_ROWS * display->scale;
+
+    NRFX_ASSERT(len <= SEGMENT_MAX_DIGITS);
+
+    for(uint8_t i = 0; i < num_cells; i++) {
+        const uint8_t old = i < display->num_digits ? display->lit[i] : 0;
+        const uint8_t new = i < len ? character_segments(text[i]) : 0;
+
+        const uint8_t off = old & ~new;
+
+        // Turn off what is no longer needed, the rest is drawn by segment_display_draw.
+        // Erasing also clears the corners shared with segments that stay on, so those are drawn again
+        fill_segments(display, i, off, &display->background);
+
+        display->lit[i] = old & new & ~touching_segments(off);
+        display->next[i] = new;
+
+        // A glyph is sent whole, whenever any of its segments change
+        if(old != new)
+            stats.bitmap_bytes += FILL_COMMAND_BYTES + len_glyph * len_glyph * sizeof(pixel_t);
+    }
+
+    display->num_digits = len;
+}
+
+
+void segment_display_draw(segment_display_t * const display) {
+    NRFX_ASSERT(display != NULL);
+
+    for(uint8_t i = 0; i < display->num_digits; i++) {
+        const rect_t cell = digit_rect(display, i);
+
+        // The compositor erases whatever is in its dirty areas, so draw the whole digit again
+        if(compositor_was_flushed(&cell))
+            display->lit[i] = 0;
+
+        fill_segments(display, i, display->next[i] & ~display->lit[i], &display->color);
+        display->lit[i] = display->next[i];
+    }
+}
+
+
+const segment_stats_t * segment_get_stats() {
+    return &stats;
+}
+
+
+void segment_reset_stats() {
+    stats.bytes = 0;
+    stats.bitmap_bytes = 0;
+}
@@ -0,0 +1,63 @@
+#ifndef _SEGMENT_H_
+#define _SEGMENT_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "ST7735.h"
+
+
+// Big digits drawn as seven segments, every segment is a single filled rectangle.
+// Only the segments that change are sent to the display, so changing a digit costs
+// a few small fills instead of a whole block of pixels.
+// A digit takes the same space as a glyph of the same scale.
+//
+// Updating is split in two, such that the digits can share an area with compositor widgets:
+// segment_display_set erases the segments that turn off (before compositor_flush),
+// segment_display_draw draws the segments that turn on (after compositor_flush).
+
+
+#define SEGMENT_MAX_DIGITS  4
+
+
+typedef struct _segment_display {
+    uint8_t x;
+    uint8_t y;
+    uint8_t scale;
+    pixel_t color;
+    pixel_t background;
+    uint8_t num_digits;                 // Digits that are shown
+    uint8_t lit[SEGMENT_MAX_DIGITS];    // Segments that are on the display, per digit
+    uint8_t next[SEGMENT_MAX_DIGITS];   // Segments that should be on, drawn by segment_display_draw
+} segment_display_t;
+
+typedef struct _segment_stats {
+    uint32_t bytes;                     // Bytes sent for segments (commands and pixels)
+    uint32_t bitmap_bytes;              // Bytes the same changes would take as glyphs
+} segment_stats_t;
+
+
+void segment_display_init(  segment_display_t * const display,
+                            const uint8_t x,
+                            const uint8_t y,
+                            const uint8_t scale,
+                            const pixel_t * const color,
+                            const pixel_t * const background);
+
+// Change the size of the digits, erases the digits on the display at the old size.
+// segment_display_set and segment_display_draw then draw all of them again
+void segment_display_set_scale(segment_display_t * const display, const uint8_t scale);
+
+// Set the digits to show, only '0' - '9' and '-' are supported.
+// Erases the segments that turn off right away
+void segment_display_set(segment_display_t * const display, const char * const text);
+
+// Draw the segments that turn on, and redraw digits the compositor painted over
+void segment_display_draw(segment_display_t * const display);
+
+// Statistics since the last reset, for all segment displays together
+const segment_stats_t * segment_get_stats();
+void segment_reset_stats();
+
+
+#endif//_SEGMENT_H_
@@ -0,0 +1,180 @@
+#include "sparkline.h"
+
+#include <string.h>
+
+#include "nrf_assert.h"
+
+#include "log.h"
+
+
+
+static sparkline_stats_t stats = {0};
+
+
+static inline int16_t round_down(const int16_t value, const int16_t step);
+static inline uint8_t value_to_x(const sparkline_t * const sparkline, const int16_t value);
+static inline int16_t sample_get(const sparkline_t * const sparkline, const uint8_t index);
+static bool update_range(sparkline_t * const sparkline);
+static void fill_span(const sparkline_t * const sparkline, const uint8_t line, const uint8_t start, const uint8_t len, const pixel_t * const color);
+static void update_line(sparkline_t * const sparkline, const uint8_t line, const uint8_t start, const uint8_t len);
+
+
+
+// Round towards minus infinity, also for negative values
+static inline int16_t round_down(const int16_t value, const int16_t step) {
+    const int16_t remainder = value % step;
+
+    return remainder < 0 ? value - remainder - step : value - remainder;
+}
+
+
+// Position of a value relative to the area, high values at the top
+static inline uint8_t value_to_x(const sparkline_t * const sparkline, const int16_t value) {
+    return ((int32_t)(sparkline->max - value) * (sparkline->area.x_len - 1)) / (sparkline->max - sparkline->min);
+}
+
+
+// The sample shown in a line, 0 is the oldest
+static inline int16_t sample_get(const sparkline_t * const sparkline, const uint8_t index) {
+    return sparkline->samples[(sparkline->head + index) % SPARKLINE_MAX_LEN];
+}
+
+
+// Fit the range to the samples, returns true when it changed
+static bool update_range(sparkline_t * const sparkline) {
+    int16_t min = INT16_MAX;
+    int16_t max = INT16_MIN;
+
+    for(uint8_t i = 0; i < sparkline->num_samples; i++) {
+        const int16_t value = sample_get(sparkline, i);
+
+        min = value < min ? value : min;
+        max = value > max ? value : max;
+    }
+
+    min = round_down(min, sparkline->step);
+    max = round_down(max, sparkline->step) + sparkline->step;
+
+    if(min == sparkline->min && max == sparkline->max)
+        return false;
+
+    sparkline->min = min;
+    sparkline->max = max;
+
+    return true;
+}
+
+
+static void fill_span(const sparkline_t * const sparkline, const uint8_t line, const uint8_t start, const uint8_t len, const pixel_t * const color) {
+    if(len == 0)
+        return;
+
+    ST7735_set_bounds(sparkline->area.x + start, sparkline->area.y + line, len, 1);
+    ST7735_fill_bounds(color);
+
+    stats.fills++;
+    stats.pixels += len;
+}
+
+
+// Change the span of a line, only sending the pixels that differ
+static void update_line(sparkline_t * const sparkline, const uint8_t line, const uint8_t start, const uint8_t len) {
+    const uint8_t old_start = sparkline->span_start[line];
+    const uint8_t old_len = sparkline->span_len[line];
+    const uint8_t end = start + len;
+    const uint8_t old_end = old_start + old_len;
+
+    if(old_len == 0) {
+        fill_span(sparkline, line, start, len, &sparkline->color);
+    } else if(len == 0 || end <= old_start || start >= old_end) {
+        // No overlap, replace the whole span
+        fill_span(sparkline, line, old_start, old_len, &sparkline->background);
+        fill_span(sparkline, line, start, len, &sparkline->color);
+    } else {
+        // The spans overlap, only the ends can differ
+        if(old_start < start)
+            fill_span(sparkline, line, old_start, start - old_start, &sparkline->background);
+        else
+            fill_span(sparkline, line, start, old_start - start, &sparkline->color);
+
+        if(old_end > end)
+            fill_span(sparkline, line, end, old_end - end, &sparkline->background);
+        else
+            fill_span(sparkline, line, old_end, end - old_end, &sparkline->color);
+    }
+
+    sparkline->span_start[line] = start;
+    sparkline->span_len[line] = len;
+}
+
+
+void sparkline_init(sparkline_t * const sparkline,
+                    const rect_t * const area,
+                    const int16_t step,
+                    const pixel_t * const color,
+                    const pixel_t * const background) {
+    NRFX_ASSERT(sparkline != NULL);
+    NRFX_ASSERT(area != NULL);
+    NRFX_ASSERT(area->y_len <= SPARKLINE_MAX_LEN);
+    NRFX_ASSERT(step > 0);
+
+    memset(sparkline, 0x00, sizeof(*sparkline));
+    sparkline->area = *area;
+    sparkline->step = step;
+    sparkline->color = *color;
+    sparkline->background = *background;
+
+    ST7735_set_bounds(area->x, area->y, area->x_len, area->y_len);
+    ST7735_fill_bounds(background);
+}
+
+
+void sparkline_add_sample(sparkline_t * const sparkline, const int16_t value) {
+    NRFX_ASSERT(sparkline != NULL);
+
+    const uint8_t len = sparkline->area.y_len;
+
+    // Drop the oldest sample when the sparkline is full
+    if(sparkline->num_samples == len) {
+        sparkline->head = (sparkline->head + 1) % SPARKLINE_MAX_LEN;
+        sparkline->num_samples--;
+    }
+
+    sparkline->samples[(sparkline->head + sparkline->num_samples) % SPARKLINE_MAX_LEN] = value;
+    sparkline->num_samples++;
+
+    // A new range moves every span, start over from an empty area
+    if(update_range(sparkline)) {
+        ST7735_set_bounds(sparkline->area.x, sparkline->area.y, sparkline->area.x_len, len);
+        ST7735_fill_bounds(&sparkline->background);
+        memset(sparkline->span_len, 0x00, sizeof(sparkline->span_len));
+
+        stats.repaints++;
+        stats.fills++;
+        stats.pixels += sparkline->area.x_len * len;
+    }
+
+    // The samples are right aligned, every line connects its sample to the one before it
+    const uint8_t first = len - sparkline->num_samples;
+
+    for(uint8_t i = 0; i < sparkline->num_samples; i++) {
+        const uint8_t x = value_to_x(sparkline, sample_get(sparkline, i));
+        const uint8_t previous = i > 0 ? value_to_x(sparkline, sample_get(sparkline, i - 1)) : x;
+        const uint8_t start = x < previous ? x : previous;
+        const uint8_t end = x < previous ? previous : x;
+
+        update_line(sparkline, first + i, start, end - start + 1);
+    }
+}
+
+
+const sparkline_stats_t * sparkline_get_stats() {
+    return &stats;
+}
+
+
+void sparkline_reset_stats() {
+    stats.fills = 0;
+    stats.pixels = 0;
+    stats.repaints = 0;
+}
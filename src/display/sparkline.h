@@ -0,0 +1,55 @@
+#ifndef _SPARKLINE_H_
+#define _SPARKLINE_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "ST7735.h"
+#include "compositor.h"
+
+
+// Small trend line, one sample per line (y) with the newest on the right.
+// Every line remembers the span (along x) it drew last time, a new sample only
+// erases and draws the parts of the spans that changed.
+// The range scales to the samples in steps, the whole sparkline is only redrawn when the range changes.
+
+
+#define SPARKLINE_MAX_LEN   64
+
+
+typedef struct _sparkline {
+    rect_t area;
+    pixel_t color;
+    pixel_t background;
+    int16_t step;                           // The range is a multiple of this
+    int16_t min;                            // Current range
+    int16_t max;
+    int16_t samples[SPARKLINE_MAX_LEN];     // Ring buffer, the oldest at head
+    uint8_t num_samples;
+    uint8_t head;
+    uint8_t span_start[SPARKLINE_MAX_LEN];  // What is on the display, per line relative to the area
+    uint8_t span_len[SPARKLINE_MAX_LEN];    // 0 when the line is empty
+} sparkline_t;
+
+typedef struct _sparkline_stats {
+    uint32_t fills;                         // Rectangles sent
+    uint32_t pixels;                        // Pixels sent
+    uint32_t repaints;                      // Full redraws because the range changed
+} sparkline_stats_t;
+
+
+// Clears the area, area->y_len is the number of samples that are shown
+void sparkline_init(sparkline_t * const sparkline,
+                    const rect_t * const area,
+                    const int16_t step,
+                    const pixel_t * const color,
+                    const pixel_t * const background);
+
+void sparkline_add_sample(sparkline_t * const sparkline, const int16_t value);
+
+// Statistics since the last reset, for all sparklines together
+const sparkline_stats_t * sparkline_get_stats();
+void sparkline_reset_stats();
+
+
+#endif//_SPARKLINE_H_
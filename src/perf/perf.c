@@ -0,0 +1,13 @@
+#include "perf.h"
+
+
+
+void perf_init() {
+    // The cycle counter is part of the trace unit, which needs to be enabled first
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+
+    if((DWT->CTRL & DWT_CTRL_CYCCNTENA_Msk) == 0) {
+        DWT->CYCCNT = 0;
+        DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+    }
+}
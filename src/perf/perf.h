@@ -0,0 +1,45 @@
+#ifndef _PERF_H_
+#define _PERF_H_
+
+#include <stdint.h>
+
+#include "nrf.h"
+#include "app_timer.h"
+
+
+// The CPU runs at 64MHz, used to convert cycles to time
+#define PERF_CYCLES_PER_US      64
+
+
+// Enable the DWT cycle counter, safe to call more than once
+void perf_init();
+
+
+// Current value of the cycle counter, wraps every ~67 seconds.
+// Take the (unsigned) difference of two readings to time a piece of code.
+// The counter stops while the CPU sleeps, so this measures the time the CPU was awake
+static inline uint32_t perf_cycles() {
+    return DWT->CYCCNT;
+}
+
+
+static inline uint32_t perf_cycles_to_us(const uint32_t cycles) {
+    return cycles / PERF_CYCLES_PER_US;
+}
+
+
+// Wall clock time in RTC ticks (app_timer), keeps running while the CPU sleeps.
+// Resolution is one tick (~30us), use it for things that take milliseconds
+static inline uint32_t perf_ticks() {
+    return app_timer_cnt_get();
+}
+
+
+static inline uint32_t perf_ticks_to_us(const uint32_t start, const uint32_t end) {
+    const uint32_t ticks = app_timer_cnt_diff_compute(end, start);
+
+    return (uint32_t)(((uint64_t)ticks * 1000000 * (APP_TIMER_CONFIG_RTC_FREQUENCY + 1)) / APP_TIMER_CLOCK_FREQ);
+}
+
+
+#endif//_PERF_H_
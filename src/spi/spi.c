@@ -1,11 +1,61 @@
 #include "spi.h"
 
+#include <stdbool.h>
+#include <string.h>
+
+#include "sdk_config.h"
+#include "app_util_platform.h"
+#include "nrf.h"
+#include "nrf_gpio.h"
+
+#include "log.h"
+#include "perf.h"
+
+// SPI1_USE_EASY_DMA in the sdk_config selects the backend.
+// SPIM uses EasyDMA, so a transfer costs one interrupt instead of one per byte,
+// but it can only send (1 << MAXCNT_SIZE) - 1 bytes per transfer.
+// The legacy SPI driver is kept to be able to compare the two.
+#if SPI1_USE_EASY_DMA
+#include "nrfx_spim.h"
+#define SPI_BACKEND_NAME        "SPIM"
+#define SPI_MAX_TRANSFER_LEN    ((1 << SPIM1_EASYDMA_MAXCNT_SIZE) - 1)
+#else
 #include "nrfx_spi.h"
+#define SPI_BACKEND_NAME        "SPI"
+#define SPI_MAX_TRANSFER_LEN    SIZE_MAX
+#endif
+
+// With SPIM the D/C pin is driven by GPIOTE tasks, triggered through PPI by the
+// STARTED event of the transfer. The CPU only picks which of the two channels is armed.
+// The display samples D/C on the last bit of a byte, so setting it at the start is in time.
+// The legacy SPI has no STARTED event, there the pin is set before starting the transfer.
+#if SPI1_USE_EASY_DMA && NRFX_PPI_ENABLED
+#include "nrfx_gpiote.h"
+#include "nrfx_ppi.h"
+#define SPI_HARDWARE_DC         1
+#else
+#define SPI_HARDWARE_DC         0
+#endif
+
+// Repeated transfers restart the SPIM from its END event through PPI, and
+// TIMER1 counts the END events to stop after the last one.
+// The SPIM doesn't move its pointer without the list feature, so every restart sends the same buffer.
+// Without a timer (or PPI) the transfers are queued one by one
+#if SPI_HARDWARE_DC && NRFX_TIMER1_ENABLED
+#include "nrfx_timer.h"
+#define SPI_HARDWARE_REPEAT     1
+#else
+#define SPI_HARDWARE_REPEAT     0
+#endif
 
 
 
 // SPI and I2C use the same hardware, so use SPI1 instead of 0
+#if SPI1_USE_EASY_DMA
+static const nrfx_spim_t instance = NRFX_SPIM_INSTANCE(1);
+#else
 static nrfx_spi_t instance = NRFX_SPI_INSTANCE(1);
+#endif
 
 
 // These names are I2C, but the interface is actualy SPI
@@ -13,49 +63,472 @@ static nrfx_spi_t instance = NRFX_SPI_INSTANCE(1);
 #define SCL_PIN             18
 #define SDA_PIN             19
 #define CHIP_SELECT_PIN     23
+#define DATA_COMMAND_PIN    22          // 1 is data, 0 is command
 #define MOSI_PIN            SDA_PIN
 #define SCK_PIN             SCL_PIN
 
+// Maximum number of pending transfers, needs to be a power of 2 that fits in an uint8_t
+#define SPI_QUEUE_SIZE      16
+
+
+
+// A single (asynchronous) transfer in the queue
+typedef struct _spi_job {
+    const uint8_t * data;
+    size_t data_len;
+    spi_dc_t dc;
+    spi_callback_t callback;
+    void * context;
+} spi_job_t;
+
+// Ring buffer of pending transfers, the job at the head is the one on the bus.
+// The head is only changed from the interrupt, the tail only from the caller.
+static spi_job_t queue[SPI_QUEUE_SIZE];
+static volatile uint8_t queue_head = 0;
+static volatile uint8_t queue_tail = 0;
+
+// Progress of the job at the head, a job can be split up into multiple transfers
+static size_t job_offset = 0;
+static size_t chunk_len = 0;
+
+static volatile bool busy = false;
+static spi_stats_t stats = {0};
+// Level of the D/C pin as of the last transfer that was queued, for the stats
+static spi_dc_t queued_dc = SPI_DC_DATA;
+
+// Level of the D/C pin as of the last transfer that was started
+static spi_dc_t dc_level = SPI_DC_DATA;
+
+#if SPI_HARDWARE_DC
+static nrf_ppi_channel_t dc_set_channel;
+static nrf_ppi_channel_t dc_clear_channel;
+#endif
+
+#if SPI_HARDWARE_REPEAT
+static const nrfx_timer_t repeat_timer = NRFX_TIMER_INSTANCE(1);
+
+// END -> START, in a group such that the timer can disable it before the last transfer
+static nrf_ppi_channel_t repeat_restart_channel;
+static nrf_ppi_channel_group_t repeat_group;
+// END -> timer COUNT, the timer is stopped outside of repeats so other transfers are not counted
+static nrf_ppi_channel_t repeat_count_channel;
+// Timer COMPARE0 -> disable the group
+static nrf_ppi_channel_t repeat_stop_channel;
+#endif
+
+
+static inline uint8_t queue_count();
+static inline void prepare_dc(const spi_dc_t dc);
+static inline void count_transfer(const size_t data_len, const spi_dc_t dc);
+static void start_chunk();
+static void dc_init();
+#if SPI_HARDWARE_REPEAT
+static void repeat_init();
+static void repeat_done_handler(nrf_timer_event_t event_type, void * p_context);
+#endif
+static void transfer_done_handler();
+
+
 
+static inline uint8_t queue_count() {
+    return (uint8_t)(queue_tail - queue_head);
+}
+
+
+// Make sure the D/C pin has the right level when the next transfer starts.
+// Only called while the bus is idle, so the previous transfer is completely out
+static inline void prepare_dc(const spi_dc_t dc) {
+    const bool change = dc != SPI_DC_KEEP && dc != dc_level;
+
+#if SPI_HARDWARE_DC
+    // Arm the channel for the new level, disarm both when the level stays the same
+    if(change && dc == SPI_DC_DATA)
+        nrf_ppi_channel_enable(dc_set_channel);
+    else
+        nrf_ppi_channel_disable(dc_set_channel);
+
+    if(change && dc == SPI_DC_COMMAND)
+        nrf_ppi_channel_enable(dc_clear_channel);
+    else
+        nrf_ppi_channel_disable(dc_clear_channel);
+#else
+    if(change)
+        nrf_gpio_pin_write(DATA_COMMAND_PIN, dc == SPI_DC_DATA);
+#endif
+
+    if(change)
+        dc_level = dc;
+}
 
-static volatile unsigned int transfer_done = 0;
 
+// Only called with the interrupts disabled, a callback can queue transfers from the interrupt
+static inline void count_transfer(const size_t data_len, const spi_dc_t dc) {
+    if(dc != SPI_DC_KEEP && dc != queued_dc) {
+        queued_dc = dc;
+        stats.dc_toggles++;
+    }
 
+    if(queued_dc == SPI_DC_COMMAND)
+        stats.command_bytes += data_len;
+    else
+        stats.data_bytes += data_len;
+
+    stats.transactions++;
+}
+
+
+// Put the next part of the job at the head of the queue on the bus
+static void start_chunk() {
+    nrfx_err_t err;
+    const spi_job_t * const job = &queue[queue_head % SPI_QUEUE_SIZE];
+    const size_t remaining = job->data_len - job_offset;
+
+    // Every chunk of a job has the same level, only the first one can change it
+    prepare_dc(job_offset == 0 ? job->dc : SPI_DC_KEEP);
+
+    chunk_len = remaining < SPI_MAX_TRANSFER_LEN ? remaining : SPI_MAX_TRANSFER_LEN;
+
+#if SPI1_USE_EASY_DMA
+    const nrfx_spim_xfer_desc_t xfer = NRFX_SPIM_XFER_TX(job->data + job_offset, chunk_len);
+    err = nrfx_spim_xfer(&instance, &xfer, 0);
+#else
+    const nrfx_spi_xfer_desc_t xfer = NRFX_SPI_XFER_TX(job->data + job_offset, chunk_len);
+    err = nrfx_spi_xfer(&instance, &xfer, 0);
+#endif
+    APP_ERROR_CHECK(err);
+}
+
+
+// Called from the interrupt every time a chunk is on the bus
+static void transfer_done_handler() {
+    const spi_job_t job = queue[queue_head % SPI_QUEUE_SIZE];
+
+    job_offset += chunk_len;
+
+    // Not done with this job yet, continue where we left off
+    if(job_offset < job.data_len) {
+        start_chunk();
+        return;
+    }
+
+    // Free the slot before the callback, so the callback can queue new data
+    job_offset = 0;
+    queue_head++;
+
+    if(queue_count() > 0)
+        start_chunk();
+    else
+        busy = false;
+
+    if(job.callback != NULL)
+        job.callback(job.context);
+}
+
+
+#if SPI1_USE_EASY_DMA
+static void ST7735_spi_event_handler(nrfx_spim_evt_t const * p_event, void * p_context) {
+    transfer_done_handler();
+}
+#else
 static void ST7735_spi_event_handler(nrfx_spi_evt_t const * p_event, void * p_context) {
-    transfer_done = 1;
+    transfer_done_handler();
 }
+#endif
+
 
 
-static inline void wait_for_transfer() {
-    while (transfer_done == 0) {
-        // maybe sleep here
+void spi_transfer_async(const uint8_t * const data,
+                        const size_t data_len,
+                        const spi_callback_t callback,
+                        void * const context) {
+    spi_transfer_dc_async(data, data_len, SPI_DC_KEEP, callback, context);
+}
+
+
+void spi_transfer_dc_async(const uint8_t * const data,
+                           const size_t data_len,
+                           const spi_dc_t dc,
+                           const spi_callback_t callback,
+                           void * const context) {
+    NRFX_ASSERT(data != NULL);
+    NRFX_ASSERT(data_len > 0);
+
+    // Only thread mode can wait for a free slot. In an interrupt (a callback) the SPI interrupt
+    // that would free it can't run, so a full queue there would never drain
+    if(queue_count() >= SPI_QUEUE_SIZE && current_int_priority_get() != APP_IRQ_PRIORITY_THREAD)
+        APP_ERROR_HANDLER(NRF_ERROR_BUSY);
+
+    // Wait for a free slot, the interrupt will make one
+    while(queue_count() >= SPI_QUEUE_SIZE) {
+        __WFE();
     }
 
-    transfer_done = 0;
+    CRITICAL_REGION_ENTER();
+
+    queue[queue_tail % SPI_QUEUE_SIZE] = (spi_job_t) {
+        .data = data,
+        .data_len = data_len,
+        .dc = dc,
+        .callback = callback,
+        .context = context
+    };
+    queue_tail++;
+    count_transfer(data_len, dc);
+
+    // The bus is idle, so nobody will pick this job up if we don't
+    if(!busy) {
+        busy = true;
+        start_chunk();
+    }
+
+    CRITICAL_REGION_EXIT();
 }
 
 
+void spi_wait_idle() {
+    // Every finished transfer is an interrupt, which wakes us up
+    while(busy) {
+        __WFE();
+    }
+}
+
 
 void spi_transfer(const uint8_t * const data, const size_t data_len) {
-    nrfx_err_t err;
-    const nrfx_spi_xfer_desc_t xfer = NRFX_SPI_XFER_TX(data, data_len);
+    spi_transfer_async(data, data_len, NULL, NULL);
+
+    spi_wait_idle();
+}
+
+
+#if SPI_HARDWARE_REPEAT
+// Called from the timer interrupt when the last repeat is on the bus
+static void repeat_done_handler(nrf_timer_event_t event_type, void * p_context) {
+    // The driver selected the display when the repeat was set up, but it doesn't handle
+    // the END events of a repeat, so it never deselects it. CS is active low
+    nrf_gpio_pin_set(CHIP_SELECT_PIN);
 
+    // Continue with whatever was queued in the meantime
+    if(queue_count() > 0)
+        start_chunk();
+    else
+        busy = false;
+}
+#endif
+
+
+void spi_transfer_repeat(const uint8_t * const data,
+                         const size_t data_len,
+                         const uint32_t count,
+                         const spi_dc_t dc) {
     NRFX_ASSERT(data != NULL);
     NRFX_ASSERT(data_len > 0);
+    NRFX_ASSERT(data_len <= SPI_MAX_TRANSFER_LEN);
 
-    err = nrfx_spi_xfer(&instance, &xfer, 0);
+    if(count == 0)
+        return;
+
+#if SPI_HARDWARE_REPEAT
+    // The repeats take over the bus, so everything before needs to be out
+    spi_wait_idle();
+
+    CRITICAL_REGION_ENTER();
+    busy = true;
+    count_transfer(data_len * count, dc);
+    CRITICAL_REGION_EXIT();
+
+    prepare_dc(dc);
+
+    // Stop restarting after count - 1 transfers, interrupt after the last one
+    nrfx_timer_clear(&repeat_timer);
+    nrfx_timer_compare(&repeat_timer, NRF_TIMER_CC_CHANNEL0, count - 1, false);
+    nrfx_timer_extended_compare(&repeat_timer, NRF_TIMER_CC_CHANNEL1, count,
+                                NRF_TIMER_SHORT_COMPARE1_STOP_MASK, true);
+
+    if(count > 1)
+        nrfx_ppi_group_enable(repeat_group);
+
+    nrfx_timer_enable(&repeat_timer);
+
+    // Set up the buffer, but don't let the driver start it or handle the END events
+    const nrfx_spim_xfer_desc_t xfer = NRFX_SPIM_XFER_TX(data, data_len);
+    const nrfx_err_t err = nrfx_spim_xfer(&instance, &xfer, NRFX_SPIM_FLAG_HOLD_XFER |
+                                                            NRFX_SPIM_FLAG_REPEATED_XFER |
+                                                            NRFX_SPIM_FLAG_NO_XFER_EVT_HANDLER);
+    APP_ERROR_CHECK(err);
+
+    nrf_spim_task_trigger(instance.p_reg, NRF_SPIM_TASK_START);
+
+    // Only the timer interrupt wakes us up
+    spi_wait_idle();
+#else
+    for(uint32_t i = 0; i < count; i++) {
+        spi_transfer_dc_async(data, data_len, dc, NULL, NULL);
+    }
+
+    spi_wait_idle();
+#endif
+}
+
+
+uint32_t spi_get_transaction_count() {
+    return stats.transactions;
+}
+
+
+const spi_stats_t * spi_get_stats() {
+    return &stats;
+}
+
+
+#ifdef SPI_BENCHMARK
+// Send blocks of different sizes and log how long it took
+// Build once with SPI1_USE_EASY_DMA set to 0 and once with 1 to compare the backends
+void spi_benchmark() {
+    static uint8_t data[1024];
+    static const size_t sizes[] = {1, 4, 32, 255, sizeof(data)};
+    const size_t total_bytes = 8 * sizeof(data);
+
+    perf_init();
+    memset(data, 0x00, sizeof(data));
+
+    for(size_t i = 0; i < sizeof(sizes)/sizeof(sizes[0]); i++) {
+        const size_t count = total_bytes / sizes[i];
+        uint32_t start, blocking, queued, cpu;
+
+        // Blocking, every transfer waits for the previous one
+        start = perf_cycles();
+        for(size_t n = 0; n < count; n++) {
+            spi_transfer(data, sizes[i]);
+        }
+        blocking = perf_cycles() - start;
+
+        // Asynchronous, measure both the time spent queueing and the total time
+        start = perf_cycles();
+        for(size_t n = 0; n < count; n++) {
+            spi_transfer_async(data, sizes[i], NULL, NULL);
+        }
+        cpu = perf_cycles() - start;
+        spi_wait_idle();
+        queued = perf_cycles() - start;
+
+        NRF_LOG_INFO("%s %u x %u bytes", SPI_BACKEND_NAME, count, sizes[i]);
+        NRF_LOG_INFO("    blocking: %u us (%u kB/s)",
+                     perf_cycles_to_us(blocking), (total_bytes * 1000) / perf_cycles_to_us(blocking));
+        NRF_LOG_INFO("    async: %u us (%u kB/s), %u us spent queueing",
+                     perf_cycles_to_us(queued), (total_bytes * 1000) / perf_cycles_to_us(queued),
+                     perf_cycles_to_us(cpu));
+        log_flush();
+    }
+}
+#endif
+
+
+static void dc_init() {
+#if SPI_HARDWARE_DC
+    nrfx_err_t err;
+
+    // Other modules (buttons) can share the GPIOTE driver
+    if(!nrfx_gpiote_is_init()) {
+        err = nrfx_gpiote_init();
+        APP_ERROR_CHECK(err);
+    }
+
+    // Hand the pin over to a GPIOTE channel, start in data mode
+    const nrfx_gpiote_out_config_t config = NRFX_GPIOTE_CONFIG_OUT_TASK_TOGGLE(true);
+
+    err = nrfx_gpiote_out_init(DATA_COMMAND_PIN, &config);
+    APP_ERROR_CHECK(err);
+    nrfx_gpiote_out_task_enable(DATA_COMMAND_PIN);
+
+    const uint32_t started_event = nrf_spim_event_address_get(instance.p_reg, NRF_SPIM_EVENT_STARTED);
+
+    err = nrfx_ppi_channel_alloc(&dc_set_channel);
+    APP_ERROR_CHECK(err);
+    err = nrfx_ppi_channel_assign(dc_set_channel, started_event, nrfx_gpiote_set_task_addr_get(DATA_COMMAND_PIN));
+    APP_ERROR_CHECK(err);
+
+    err = nrfx_ppi_channel_alloc(&dc_clear_channel);
+    APP_ERROR_CHECK(err);
+    err = nrfx_ppi_channel_assign(dc_clear_channel, started_event, nrfx_gpiote_clr_task_addr_get(DATA_COMMAND_PIN));
     APP_ERROR_CHECK(err);
+#else
+    nrf_gpio_cfg_output(DATA_COMMAND_PIN);
+    nrf_gpio_pin_set(DATA_COMMAND_PIN);
+#endif
 
-    // Maybe move this to before the function? Overlap execution.
-    // Does not work out-of-the-box for commands, need to toggle the command pin
-    // Maybe add a 'bool blocking' parameter to set this?
-    wait_for_transfer();
+    dc_level = SPI_DC_DATA;
 }
 
 
+#if SPI_HARDWARE_REPEAT
+static void repeat_init() {
+    nrfx_err_t err;
+
+    const nrfx_timer_config_t config = {
+        .frequency = NRF_TIMER_FREQ_16MHz,
+        .mode = NRF_TIMER_MODE_COUNTER,
+        .bit_width = NRF_TIMER_BIT_WIDTH_32,
+        .interrupt_priority = NRFX_SPIM_DEFAULT_CONFIG_IRQ_PRIORITY, // Same as the SPI, they share the queue
+        .p_context = NULL
+    };
+
+    err = nrfx_timer_init(&repeat_timer, &config, repeat_done_handler);
+    APP_ERROR_CHECK(err);
+
+    const uint32_t end_event = nrfx_spim_end_event_get(&instance);
+
+    err = nrfx_ppi_channel_alloc(&repeat_restart_channel);
+    APP_ERROR_CHECK(err);
+    err = nrfx_ppi_channel_assign(repeat_restart_channel, end_event, nrfx_spim_start_task_get(&instance));
+    APP_ERROR_CHECK(err);
+
+    err = nrfx_ppi_group_alloc(&repeat_group);
+    APP_ERROR_CHECK(err);
+    err = nrfx_ppi_channel_include_in_group(repeat_restart_channel, repeat_group);
+    APP_ERROR_CHECK(err);
+
+    err = nrfx_ppi_channel_alloc(&repeat_count_channel);
+    APP_ERROR_CHECK(err);
+    err = nrfx_ppi_channel_assign(repeat_count_channel, end_event,
+                                  nrfx_timer_task_address_get(&repeat_timer, NRF_TIMER_TASK_COUNT));
+    APP_ERROR_CHECK(err);
+    err = nrfx_ppi_channel_enable(repeat_count_channel);
+    APP_ERROR_CHECK(err);
+
+    err = nrfx_ppi_channel_alloc(&repeat_stop_channel);
+    APP_ERROR_CHECK(err);
+    err = nrfx_ppi_channel_assign(repeat_stop_channel,
+                                  nrfx_timer_compare_event_address_get(&repeat_timer, NRF_TIMER_CC_CHANNEL0),
+                                  nrfx_ppi_task_addr_group_disable_get(repeat_group));
+    APP_ERROR_CHECK(err);
+    err = nrfx_ppi_channel_enable(repeat_stop_channel);
+    APP_ERROR_CHECK(err);
+}
+#endif
+
+
 void ST7735_spi_init() {
     nrfx_err_t err;
 
+#if SPI1_USE_EASY_DMA
+    const nrfx_spim_config_t config  = {
+        .sck_pin = SCK_PIN,
+        .mosi_pin = MOSI_PIN,
+        .miso_pin = NRFX_SPIM_PIN_NOT_USED,
+        .ss_pin = CHIP_SELECT_PIN,
+        .ss_active_high = false,
+        .irq_priority = NRFX_SPIM_DEFAULT_CONFIG_IRQ_PRIORITY,
+        .orc = 0xFF, // what to transmit when receiving. Not sure if it matters in our case
+        .frequency = NRF_SPIM_FREQ_8M,
+        .mode = NRF_SPIM_MODE_0,
+        .bit_order = NRF_SPIM_BIT_ORDER_MSB_FIRST
+    };
+
+    err = nrfx_spim_init(&instance,
+                         &config,
+                         ST7735_spi_event_handler,
+                         NULL);
+#else
     const nrfx_spi_config_t config  = {
         .sck_pin = SCK_PIN,
         .mosi_pin = MOSI_PIN,
@@ -72,5 +545,14 @@ void ST7735_spi_init() {
                         &config,
                         ST7735_spi_event_handler,
                         NULL);
+#endif
     APP_ERROR_CHECK(err);
+
+    dc_init();
+
+#if SPI_HARDWARE_REPEAT
+    repeat_init();
+#endif
+
+    NRF_LOG_INFO("SPI backend: %s, %s D/C", SPI_BACKEND_NAME, SPI_HARDWARE_DC ? "hardware" : "software");
 }
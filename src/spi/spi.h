@@ -5,8 +5,72 @@
 #include <stddef.h> // size_t
 
 
+// Called from the SPI interrupt when an asynchronous transfer is done.
+// Do not wait on the SPI from here, the interrupt can't finish the transfer we'd wait for.
+typedef void (*spi_callback_t)(void * context);
+
+// Level of the display D/C pin during a transfer
+typedef enum {
+    SPI_DC_KEEP,        // Leave the pin as it is
+    SPI_DC_COMMAND,     // Low, the bytes are commands
+    SPI_DC_DATA,        // High, the bytes are parameters or pixels
+} spi_dc_t;
+
+
+// What was queued since boot, counted when a transfer is queued
+typedef struct _spi_stats {
+    uint32_t transactions;      // Calls to spi_transfer(_async), a hardware repeat counts as one
+    uint32_t command_bytes;     // Bytes queued with D/C low, every command is one byte
+    uint32_t data_bytes;        // Bytes queued with D/C high
+    uint32_t dc_toggles;        // Changes of the D/C level
+} spi_stats_t;
+
+
+// Blocking transfer, returns when all queued data (including this) is on the bus
 void spi_transfer(const uint8_t * const data, const size_t data_len);
 
+// Queue a transfer and return immediately, transfers are sent in the order they are queued.
+// The data must stay valid (and in RAM when using EasyDMA) until the callback is called.
+// The callback is optional.
+// When the queue is full this sleeps until there is room, which only works in thread mode.
+// Queueing into a full queue from an interrupt (like a callback) is an error (NRF_ERROR_BUSY)
+void spi_transfer_async(const uint8_t * const data,
+                        const size_t data_len,
+                        const spi_callback_t callback,
+                        void * const context);
+
+// Same as spi_transfer_async, but the D/C pin is switched to the given level
+// right before the transfer goes on the bus. The caller doesn't have to wait
+// for the queue to drain to change the level, so commands and data can be queued together.
+void spi_transfer_dc_async(const uint8_t * const data,
+                           const size_t data_len,
+                           const spi_dc_t dc,
+                           const spi_callback_t callback,
+                           void * const context);
+
+// Send the same buffer count times in a row and wait until it's done.
+// With SPIM the hardware restarts the transfers, the CPU sleeps until the last one.
+// The data needs to fit in a single transfer (255 bytes with SPIM)
+void spi_transfer_repeat(const uint8_t * const data,
+                         const size_t data_len,
+                         const uint32_t count,
+                         const spi_dc_t dc);
+
+// Sleep until all queued transfers are done
+void spi_wait_idle();
+
+// Number of SPI transactions (calls to spi_transfer(_async)) since boot.
+// Take the difference of two readings to get the cost of an operation
+uint32_t spi_get_transaction_count();
+
+// Take the difference of two copies to get the cost of an operation
+const spi_stats_t * spi_get_stats();
+
+#ifdef SPI_BENCHMARK
+// Log the throughput of blocking and asynchronous transfers
+void spi_benchmark();
+#endif
+
 void ST7735_spi_init();
 
 #endif//_SPI_H_
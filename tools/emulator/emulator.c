@@ -0,0 +1,534 @@
+// Host emulator of the display, runs the drawing code of src/display on Linux.
+//
+// Build and run from the root of the repository:
+//   make -C tools/emulator && tools/emulator/emulator -o /tmp/frames -n 20
+// Or feed it the updates of a script (see read_script_line), like the regression check does:
+//   make -C tools/emulator check
+//
+// The SPI driver is replaced by a fake that decodes the byte stream the way the ST7735 does:
+// CASET/RASET set the window, RAMWR writes pixels into an emulated 132x162 GRAM following
+// MADCTL, and the mode, scroll and partial commands are kept for the snapshots.
+// After display_init and after every sensor update the queued drawing is run to the end,
+// the bytes and transactions of that frame are reported and the panel is written as a PPM.
+//
+// Transfers finish the moment they are queued. The clock behind perf_ticks and the cycle
+// counter only advances with the bytes on the (8MHz) bus, the delays and a second per
+// sensor update, so times and cycles in the logs are not those of the target.
+// Bytes and transactions are exact.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <stdbool.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#include "nrf.h"
+#include "nrf_delay.h"
+#include "app_timer.h"
+
+#include "spi.h"
+#include "display.h"
+#include "Si7021.h"
+
+
+// The whole memory of the controller, the panel shows part of it
+#define GRAM_COLUMNS    132
+#define GRAM_ROWS       162
+
+#define SPI_NS_PER_BYTE 1000
+
+// Time between sensor updates, the fast period of the sampler
+#define UPDATE_INTERVAL_MS  1000
+
+#define SWRESET 0x01
+#define SLPIN   0x10
+#define SLPOUT  0x11
+#define PTLON   0x12
+#define NORON   0x13
+#define DISPOFF 0x28
+#define DISPON  0x29
+#define CASET   0x2A
+#define RASET   0x2B
+#define RAMWR   0x2C
+#define PTLAR   0x30
+#define VSCRDEF 0x33
+#define MADCTL  0x36
+#define VSCSAD  0x37
+#define IDMOFF  0x38
+#define IDMON   0x39
+
+#define MADCTL_MY       (1 << 7)
+#define MADCTL_MX       (1 << 6)
+#define MADCTL_MV       (1 << 5)
+
+
+// What the controller knows, as far as the firmware uses it
+typedef struct _controller {
+    uint16_t gram[GRAM_ROWS][GRAM_COLUMNS];
+
+    uint8_t command;
+    uint8_t params[8];
+    uint8_t num_params;
+
+    uint8_t xs, xe, ys, ye;     // Window
+    uint8_t x, y;               // Write pointer, in window (MADCTL) coordinates
+    int16_t high_byte;          // First byte of a pixel, -1 when waiting for one
+    uint8_t madctl;
+
+    bool sleeping;
+    bool display_on;
+    bool idle;
+    bool partial;
+    uint8_t partial_start, partial_end;
+    uint8_t scroll_top, scroll_len, scroll_start;
+} controller_t;
+
+
+static controller_t lcd;
+
+static bool dc_data = true;
+static spi_stats_t stats = {0};
+
+// Stats at the start of the frame that is being run
+static spi_stats_t frame_start = {0};
+
+static uint64_t now_ns = 0;
+static bool verbose = false;
+
+static DWT_Type dwt;
+static CoreDebug_Type core_debug;
+DWT_Type * const DWT = &dwt;
+CoreDebug_Type * const CoreDebug = &core_debug;
+
+
+static void advance_clock(const uint64_t ns);
+static void decode_byte(const uint8_t byte);
+static void apply_command();
+static void write_pixel(const uint16_t pixel);
+static void write_snapshot(const char * const path);
+static void run_frame(const char * const name, const char * const directory);
+static bool read_script_line(FILE * const script, temperature_sensor_data_t * const inside, temperature_sensor_data_t * const outside);
+
+
+
+static void advance_clock(const uint64_t ns) {
+    now_ns += ns;
+    dwt.CYCCNT = (uint32_t)(now_ns * 64 / 1000);
+}
+
+
+uint32_t app_timer_cnt_get() {
+    return (uint32_t)((now_ns * APP_TIMER_CLOCK_FREQ) / 1000000000) & 0xFFFFFF;
+}
+
+
+uint32_t app_timer_cnt_diff_compute(const uint32_t end, const uint32_t start) {
+    return (end - start) & 0xFFFFFF;
+}
+
+
+void nrf_delay_us(const uint32_t us) {
+    advance_clock((uint64_t)us * 1000);
+}
+
+
+void nrf_delay_ms(const uint32_t ms) {
+    advance_clock((uint64_t)ms * 1000000);
+}
+
+
+void emu_log(const char * const format, ...) {
+    va_list args;
+
+    if(!verbose)
+        return;
+
+    va_start(args, format);
+    vprintf(format, args);
+    va_end(args);
+    printf("\n");
+}
+
+
+
+// The fake SPI, every transfer is decoded and done before the call returns
+
+void spi_transfer_dc_async(const uint8_t * const data,
+                           const size_t data_len,
+                           const spi_dc_t dc,
+                           const spi_callback_t callback,
+                           void * const context) {
+    NRFX_ASSERT(data != NULL);
+    NRFX_ASSERT(data_len > 0);
+
+    if(dc != SPI_DC_KEEP && (dc == SPI_DC_DATA) != dc_data) {
+        dc_data = dc == SPI_DC_DATA;
+        stats.dc_toggles++;
+    }
+
+    if(dc_data)
+        stats.data_bytes += data_len;
+    else
+        stats.command_bytes += data_len;
+
+    stats.transactions++;
+
+    for(size_t i = 0; i < data_len; i++) {
+        decode_byte(data[i]);
+    }
+
+    advance_clock((uint64_t)data_len * SPI_NS_PER_BYTE);
+
+    if(callback != NULL)
+        callback(context);
+}
+
+
+void spi_transfer_async(const uint8_t * const data,
+                        const size_t data_len,
+                        const spi_callback_t callback,
+                        void * const context) {
+    spi_transfer_dc_async(data, data_len, SPI_DC_KEEP, callback, context);
+}
+
+
+void spi_transfer(const uint8_t * const data, const size_t data_len) {
+    spi_transfer_async(data, data_len, NULL, NULL);
+}
+
+
+// Counted like the hardware repeat, one transaction for all of them
+void spi_transfer_repeat(const uint8_t * const data,
+                         const size_t data_len,
+                         const uint32_t count,
+                         const spi_dc_t dc) {
+    if(count == 0)
+        return;
+
+    spi_transfer_dc_async(data, data_len, dc, NULL, NULL);
+
+    for(uint32_t i = 1; i < count; i++) {
+        for(size_t b = 0; b < data_len; b++) {
+            decode_byte(data[b]);
+        }
+
+        stats.data_bytes += data_len;
+        advance_clock((uint64_t)data_len * SPI_NS_PER_BYTE);
+    }
+}
+
+
+void spi_wait_idle() {
+}
+
+
+uint32_t spi_get_transaction_count() {
+    return stats.transactions;
+}
+
+
+const spi_stats_t * spi_get_stats() {
+    return &stats;
+}
+
+
+void ST7735_spi_init() {
+    dc_data = true;
+}
+
+
+
+// The controller
+
+static void decode_byte(const uint8_t byte) {
+    if(!dc_data) {
+        lcd.command = byte;
+        lcd.num_params = 0;
+        lcd.high_byte = -1;
+        apply_command();
+        return;
+    }
+
+    if(lcd.command == RAMWR) {
+        if(lcd.high_byte < 0) {
+            lcd.high_byte = byte;
+        } else {
+            write_pixel((lcd.high_byte << 8) | byte);
+            lcd.high_byte = -1;
+        }
+        return;
+    }
+
+    if(lcd.num_params < sizeof(lcd.params)) {
+        lcd.params[lcd.num_params++] = byte;
+        apply_command();
+    }
+}
+
+
+// Called for the command byte and after every parameter, a command takes effect once it has all of them
+static void apply_command() {
+    const uint8_t * const p = lcd.params;
+
+    switch(lcd.command) {
+    case SWRESET:
+        memset(&lcd, 0x00, sizeof(lcd));
+        lcd.sleeping = true;
+        lcd.high_byte = -1;
+        break;
+
+    case SLPIN:     lcd.sleeping = true;    break;
+    case SLPOUT:    lcd.sleeping = false;   break;
+    case PTLON:     lcd.partial = true;     break;
+    case NORON:     lcd.partial = false;    break;
+    case DISPOFF:   lcd.display_on = false; break;
+    case DISPON:    lcd.display_on = true;  break;
+    case IDMOFF:    lcd.idle = false;       break;
+    case IDMON:     lcd.idle = true;        break;
+
+    case RAMWR:
+        lcd.x = lcd.xs;
+        lcd.y = lcd.ys;
+        break;
+
+    case CASET:
+        if(lcd.num_params == 4) {
+            lcd.xs = p[1];
+            lcd.xe = p[3];
+        }
+        break;
+
+    case RASET:
+        if(lcd.num_params == 4) {
+            lcd.ys = p[1];
+            lcd.ye = p[3];
+        }
+        break;
+
+    case MADCTL:
+        if(lcd.num_params == 1)
+            lcd.madctl = p[0];
+        break;
+
+    case PTLAR:
+        if(lcd.num_params == 4) {
+            lcd.partial_start = p[1];
+            lcd.partial_end = p[3];
+        }
+        break;
+
+    case VSCRDEF:
+        if(lcd.num_params == 6) {
+            lcd.scroll_top = p[1];
+            lcd.scroll_len = p[3];
+        }
+        break;
+
+    case VSCSAD:
+        if(lcd.num_params == 2)
+            lcd.scroll_start = p[1];
+        break;
+
+    default:
+        break;
+    }
+}
+
+
+// Columns along x, rows along y, exchanged and mirrored as MADCTL says
+static void write_pixel(const uint16_t pixel) {
+    uint8_t column = lcd.x;
+    uint8_t row = lcd.y;
+
+    if(lcd.madctl & MADCTL_MV) {
+        const uint8_t tmp = column;
+        column = row;
+        row = tmp;
+    }
+
+    if(lcd.madctl & MADCTL_MX)
+        column = GRAM_COLUMNS - 1 - column;
+
+    if(lcd.madctl & MADCTL_MY)
+        row = GRAM_ROWS - 1 - row;
+
+    if(column < GRAM_COLUMNS && row < GRAM_ROWS)
+        lcd.gram[row][column] = pixel;
+
+    // The pointer wraps to the start of the window
+    if(lcd.x++ >= lcd.xe) {
+        lcd.x = lcd.xs;
+
+        if(lcd.y++ >= lcd.ye)
+            lcd.y = lcd.ys;
+    }
+}
+
+
+// What the panel shows: black when off, scrolled, partial and idle mode applied
+static void write_snapshot(const char * const path) {
+    FILE * const file = fopen(path, "wb");
+
+    if(file == NULL) {
+        perror(path);
+        exit(EXIT_FAILURE);
+    }
+
+    fprintf(file, "P6\n%u %u\n255\n", GRAM_COLUMNS, GRAM_ROWS);
+
+    for(uint8_t line = 0; line < GRAM_ROWS; line++) {
+        uint8_t row = line;
+        bool shown = lcd.display_on && !lcd.sleeping;
+
+        if(lcd.scroll_len > 0 && line >= lcd.scroll_top && line < lcd.scroll_top + lcd.scroll_len)
+            row = lcd.scroll_top + (line - lcd.scroll_top + lcd.scroll_start - lcd.scroll_top) % lcd.scroll_len;
+
+        if(lcd.partial && (line < lcd.partial_start || line > lcd.partial_end))
+            shown = false;
+
+        for(uint8_t column = 0; column < GRAM_COLUMNS; column++) {
+            const uint16_t pixel = shown ? lcd.gram[row][column] : 0;
+            uint8_t rgb[3] = {
+                ((pixel >> 11) & 0x1F) << 3,
+                ((pixel >> 5) & 0x3F) << 2,
+                (pixel & 0x1F) << 3,
+            };
+
+            // Only the most significant bit of every color
+            for(size_t i = 0; i < sizeof(rgb); i++) {
+                if(lcd.idle)
+                    rgb[i] = rgb[i] & 0x80 ? 0xFF : 0x00;
+                else
+                    rgb[i] |= rgb[i] >> 5;
+            }
+
+            fwrite(rgb, sizeof(rgb), 1, file);
+        }
+    }
+
+    fclose(file);
+}
+
+
+// Run the queued drawing to the end, report what it cost since the last frame and take a snapshot
+static void run_frame(const char * const name, const char * const directory) {
+    const spi_stats_t start = frame_start;
+    uint32_t passes = 0;
+    char path[256];
+
+    while(display_process()) {
+        passes++;
+    }
+
+    printf("%-8s %8u %8u %8u %8u %8u %8u\n", name,
+           stats.command_bytes + stats.data_bytes - start.command_bytes - start.data_bytes,
+           stats.command_bytes - start.command_bytes,
+           stats.data_bytes - start.data_bytes,
+           stats.transactions - start.transactions,
+           stats.dc_toggles - start.dc_toggles,
+           passes + 1);
+
+    snprintf(path, sizeof(path), "%s/%s.ppm", directory, name);
+    write_snapshot(path);
+
+    frame_start = stats;
+}
+
+
+// One update per line: inside temperature and humidity, outside temperature and humidity, in hundredths.
+// Empty lines and lines starting with # are skipped. Returns false at the end of the script
+static bool read_script_line(FILE * const script, temperature_sensor_data_t * const inside, temperature_sensor_data_t * const outside) {
+    char line[128];
+    int values[4];
+
+    while(fgets(line, sizeof(line), script) != NULL) {
+        if(line[0] == '#' || line[0] == '\n')
+            continue;
+
+        if(sscanf(line, "%d %d %d %d", &values[0], &values[1], &values[2], &values[3]) != 4) {
+            fprintf(stderr, "Bad script line: %s", line);
+            exit(EXIT_FAILURE);
+        }
+
+        *inside = (temperature_sensor_data_t) { .temperature = values[0], .humidity = values[1] };
+        *outside = (temperature_sensor_data_t) { .temperature = values[2], .humidity = values[3] };
+        return true;
+    }
+
+    return false;
+}
+
+
+int main(int argc, char ** argv) {
+    const char * directory = ".";
+    unsigned int num_frames = 30;
+    FILE * script = NULL;
+    int option;
+    char name[16];
+
+    while((option = getopt(argc, argv, "o:n:s:v")) != -1) {
+        switch(option) {
+        case 'o': directory = optarg;               break;
+        case 'n': num_frames = atoi(optarg);        break;
+        case 'v': verbose = true;                   break;
+        case 's':
+            script = fopen(optarg, "r");
+            if(script == NULL) {
+                perror(optarg);
+                return EXIT_FAILURE;
+            }
+            break;
+        default:
+            fprintf(stderr, "Usage: %s [-o directory] [-n frames] [-s script] [-v]\n", argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    // The frames go in there, an existing directory is fine
+    if(mkdir(directory, 0777) != 0 && errno != EEXIST) {
+        fprintf(stderr, "Can't create the output directory %s: %s\n", directory, strerror(errno));
+        return EXIT_FAILURE;
+    }
+
+    // Out of reset the controller sleeps with the display off
+    lcd.high_byte = -1;
+    lcd.sleeping = true;
+
+    printf("%-8s %8s %8s %8s %8s %8s %8s\n", "frame", "bytes", "command", "data", "trans", "d/c", "passes");
+
+    display_init();
+    run_frame("init", directory);
+
+    // The readings of the script, or made up but repeatable ones where the outside temperature goes below zero
+    for(unsigned int i = 0; script != NULL || i < num_frames; i++) {
+        temperature_sensor_data_t inside = {
+            .temperature = 2000 + (i % 7) * 40,
+            .humidity = 4000 + ((i * 3) % 11) * 100,
+        };
+        temperature_sensor_data_t outside = {
+            .temperature = -250 + (i % 12) * 90,
+            .humidity = 8000 - (i % 20) * 100,
+        };
+
+        if(script != NULL && !read_script_line(script, &inside, &outside))
+            break;
+
+        advance_clock((uint64_t)UPDATE_INTERVAL_MS * 1000000);
+        display_set_sensor_data(&inside, &outside);
+
+        snprintf(name, sizeof(name), "frame%03u", i);
+        run_frame(name, directory);
+    }
+
+    if(script != NULL)
+        fclose(script);
+
+    printf("%-8s %8u %8u %8u %8u %8u\n", "total",
+           stats.command_bytes + stats.data_bytes, stats.command_bytes, stats.data_bytes,
+           stats.transactions, stats.dc_toggles);
+
+    return EXIT_SUCCESS;
+}
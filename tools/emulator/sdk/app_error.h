@@ -0,0 +1,17 @@
+// Host stand-in for the nRF SDK header of the same name, see tools/emulator/emulator.c
+#ifndef _EMU_APP_ERROR_H_
+#define _EMU_APP_ERROR_H_
+
+#include <stdint.h>
+#include <assert.h>
+
+
+typedef uint32_t ret_code_t;
+
+#define NRF_SUCCESS             0
+
+#define APP_ERROR_CHECK(err)    assert((err) == NRF_SUCCESS)
+#define NRFX_ASSERT(expr)       assert(expr)
+
+
+#endif//_EMU_APP_ERROR_H_
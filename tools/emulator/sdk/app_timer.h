@@ -0,0 +1,43 @@
+// Host stand-in for the nRF SDK header of the same name, see tools/emulator/emulator.c
+#ifndef _EMU_APP_TIMER_H_
+#define _EMU_APP_TIMER_H_
+
+#include <stdint.h>
+
+#include "app_error.h"
+
+
+#define APP_TIMER_CLOCK_FREQ            32768
+#define APP_TIMER_CONFIG_RTC_FREQUENCY  0
+#define APP_TIMER_TICKS(ms)             ((uint32_t)(((uint64_t)(ms) * APP_TIMER_CLOCK_FREQ) / 1000))
+
+typedef void (*app_timer_timeout_handler_t)(void * p_context);
+
+typedef enum {
+    APP_TIMER_MODE_SINGLE_SHOT,
+    APP_TIMER_MODE_REPEATED
+} app_timer_mode_t;
+
+typedef uint8_t * app_timer_id_t;
+
+#define APP_TIMER_DEF(name)     static uint8_t name##_data; static app_timer_id_t name = &name##_data
+
+
+// Timers never fire in the emulator, the clock is the fake one of the SPI and delays
+uint32_t app_timer_cnt_get();
+uint32_t app_timer_cnt_diff_compute(const uint32_t end, const uint32_t start);
+
+static inline ret_code_t app_timer_create(const app_timer_id_t * const id, const app_timer_mode_t mode, const app_timer_timeout_handler_t handler) {
+    return NRF_SUCCESS;
+}
+
+static inline ret_code_t app_timer_start(const app_timer_id_t id, const uint32_t ticks, void * const context) {
+    return NRF_SUCCESS;
+}
+
+static inline ret_code_t app_timer_stop(const app_timer_id_t id) {
+    return NRF_SUCCESS;
+}
+
+
+#endif//_EMU_APP_TIMER_H_
@@ -0,0 +1,28 @@
+// Host stand-in for the nRF SDK header of the same name, see tools/emulator/emulator.c
+#ifndef _EMU_NRF_H_
+#define _EMU_NRF_H_
+
+#include <stdint.h>
+
+
+typedef struct {
+    volatile uint32_t CTRL;
+    volatile uint32_t CYCCNT;
+} DWT_Type;
+
+typedef struct {
+    volatile uint32_t DEMCR;
+} CoreDebug_Type;
+
+// The emulator runs the cycle counter from its fake clock
+extern DWT_Type * const DWT;
+extern CoreDebug_Type * const CoreDebug;
+
+#define CoreDebug_DEMCR_TRCENA_Msk  (1UL << 24)
+#define DWT_CTRL_CYCCNTENA_Msk      (1UL << 0)
+
+// Transfers complete immediately, so there is never anything to wait for
+static inline void __WFE() {}
+
+
+#endif//_EMU_NRF_H_
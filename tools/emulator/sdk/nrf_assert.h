@@ -0,0 +1,10 @@
+// Host stand-in for the nRF SDK header of the same name, see tools/emulator/emulator.c
+#ifndef _EMU_NRF_ASSERT_H_
+#define _EMU_NRF_ASSERT_H_
+
+#include "app_error.h"
+
+#define ASSERT(expr)    assert(expr)
+
+
+#endif//_EMU_NRF_ASSERT_H_
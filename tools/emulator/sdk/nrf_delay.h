@@ -0,0 +1,13 @@
+// Host stand-in for the nRF SDK header of the same name, see tools/emulator/emulator.c
+#ifndef _EMU_NRF_DELAY_H_
+#define _EMU_NRF_DELAY_H_
+
+#include <stdint.h>
+
+
+// Advance the fake clock
+void nrf_delay_us(const uint32_t us);
+void nrf_delay_ms(const uint32_t ms);
+
+
+#endif//_EMU_NRF_DELAY_H_
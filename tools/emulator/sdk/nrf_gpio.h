@@ -0,0 +1,15 @@
+// Host stand-in for the nRF SDK header of the same name, see tools/emulator/emulator.c
+#ifndef _EMU_NRF_GPIO_H_
+#define _EMU_NRF_GPIO_H_
+
+#include <stdint.h>
+
+
+// The pins are not emulated, the D/C level is part of the fake SPI
+static inline void nrf_gpio_cfg_output(const uint32_t pin) {}
+static inline void nrf_gpio_pin_set(const uint32_t pin) {}
+static inline void nrf_gpio_pin_clear(const uint32_t pin) {}
+static inline void nrf_gpio_pin_write(const uint32_t pin, const uint32_t value) {}
+
+
+#endif//_EMU_NRF_GPIO_H_
@@ -0,0 +1,14 @@
+// Host stand-in for the nRF SDK header of the same name, see tools/emulator/emulator.c
+#ifndef _EMU_NRF_LOG_H_
+#define _EMU_NRF_LOG_H_
+
+#include "app_error.h"
+
+
+// Printed when the emulator runs with -v
+void emu_log(const char * const format, ...) __attribute__((format(printf, 1, 2)));
+
+#define NRF_LOG_INFO(...)   emu_log(__VA_ARGS__)
+
+
+#endif//_EMU_NRF_LOG_H_
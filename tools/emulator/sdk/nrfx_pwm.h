@@ -0,0 +1,79 @@
+// Host stand-in for the nrfx header of the same name, see tools/emulator/emulator.c
+// Only what the backlight uses, the PWM does nothing
+#ifndef _EMU_NRFX_PWM_H_
+#define _EMU_NRFX_PWM_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "app_error.h"
+
+
+typedef uint32_t nrfx_err_t;
+
+#define NRFX_SUCCESS                            NRF_SUCCESS
+#define NRFX_PWM_PIN_NOT_USED                   0xFF
+#define NRFX_PWM_DEFAULT_CONFIG_IRQ_PRIORITY    6
+#define NRFX_PWM_FLAG_STOP                      (1UL << 0)
+#define NRFX_PWM_FLAG_LOOP                      (1UL << 1)
+
+typedef struct {
+    uint8_t instance;
+} nrfx_pwm_t;
+
+#define NRFX_PWM_INSTANCE(id)   { .instance = (id) }
+
+typedef uint16_t nrf_pwm_values_common_t;
+
+typedef union {
+    const nrf_pwm_values_common_t * p_common;
+    const void * p_raw;
+} nrf_pwm_values_t;
+
+typedef struct {
+    nrf_pwm_values_t values;
+    uint16_t length;
+    uint32_t repeats;
+    uint32_t end_delay;
+} nrf_pwm_sequence_t;
+
+typedef enum { NRF_PWM_CLK_16MHz, NRF_PWM_CLK_8MHz, NRF_PWM_CLK_4MHz, NRF_PWM_CLK_2MHz, NRF_PWM_CLK_1MHz } nrf_pwm_clk_t;
+typedef enum { NRF_PWM_MODE_UP, NRF_PWM_MODE_UP_AND_DOWN } nrf_pwm_mode_t;
+typedef enum { NRF_PWM_LOAD_COMMON, NRF_PWM_LOAD_GROUPED, NRF_PWM_LOAD_INDIVIDUAL, NRF_PWM_LOAD_WAVE_FORM } nrf_pwm_dec_load_t;
+typedef enum { NRF_PWM_STEP_AUTO, NRF_PWM_STEP_TRIGGERED } nrf_pwm_dec_step_t;
+
+typedef struct {
+    uint8_t output_pins[4];
+    uint8_t irq_priority;
+    nrf_pwm_clk_t base_clock;
+    nrf_pwm_mode_t count_mode;
+    uint16_t top_value;
+    nrf_pwm_dec_load_t load_mode;
+    nrf_pwm_dec_step_t step_mode;
+} nrfx_pwm_config_t;
+
+typedef enum {
+    NRFX_PWM_EVT_FINISHED,
+    NRFX_PWM_EVT_END_SEQ0,
+    NRFX_PWM_EVT_END_SEQ1,
+    NRFX_PWM_EVT_STOPPED,
+} nrfx_pwm_evt_type_t;
+
+typedef void (*nrfx_pwm_handler_t)(nrfx_pwm_evt_type_t event_type);
+
+
+static inline nrfx_err_t nrfx_pwm_init(const nrfx_pwm_t * const pwm, const nrfx_pwm_config_t * const config, const nrfx_pwm_handler_t handler) {
+    return NRFX_SUCCESS;
+}
+
+static inline uint32_t nrfx_pwm_simple_playback(const nrfx_pwm_t * const pwm, const nrf_pwm_sequence_t * const sequence, const uint16_t count, const uint32_t flags) {
+    return 0;
+}
+
+static inline bool nrfx_pwm_stop(const nrfx_pwm_t * const pwm, const bool wait) {
+    return true;
+}
+
+
+#endif//_EMU_NRFX_PWM_H_
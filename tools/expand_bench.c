@@ -0,0 +1,79 @@
+// Host microbenchmark for the 1bpp to RGB565 expansion kernel in src/display/expand.c
+//
+// Build and run from the root of the repository:
+//   gcc -O2 -Isrc/display -Isrc/spi tools/expand_bench.c src/display/expand.c -o expand_bench && ./expand_bench
+//
+// Numbers on a desktop CPU only show the relative gain, use EXPAND_BENCHMARK on the target for cycles.
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include "expand.h"
+
+
+#define ROUNDS      200000
+#define NUM_BYTES   72          // A glyph at scale 3
+
+
+// The loop used before the kernel, one bit and one pixel at a time
+static void expand_bits_per_pixel(const pixel_t * const foreground, const pixel_t * const background,
+                                  const uint8_t * const bits, const size_t num_bytes, pixel_t * const pixels) {
+    for(size_t i = 0; i < num_bytes * 8; i++) {
+        pixels[i] = ((bits[i / 8] >> (i % 8)) & 0x1) ? *foreground : *background;
+    }
+}
+
+
+static double now_ns() {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+
+int main() {
+    static uint8_t bits[NUM_BYTES];
+    static pixel_t reference[NUM_BYTES * 8] __attribute__((aligned(4)));
+    static pixel_t pixels[NUM_BYTES * 8] __attribute__((aligned(4)));
+    static expand_lut_t lut;
+    const pixel_t foreground = { .raw_data = 0x1234 };
+    const pixel_t background = { .raw_data = 0xffff };
+    volatile uint16_t sink = 0;
+    double start, per_pixel, kernel;
+
+    for(size_t i = 0; i < sizeof(bits); i++) {
+        bits[i] = (uint8_t)(i * 37);
+    }
+
+    expand_lut_init(&lut, &foreground, &background);
+
+    start = now_ns();
+    for(size_t i = 0; i < ROUNDS; i++) {
+        bits[i % NUM_BYTES] ^= 1;
+        expand_bits_per_pixel(&foreground, &background, bits, NUM_BYTES, reference);
+        sink += reference[i % (NUM_BYTES * 8)].raw_data;
+    }
+    per_pixel = (now_ns() - start) / ROUNDS;
+
+    start = now_ns();
+    for(size_t i = 0; i < ROUNDS; i++) {
+        bits[i % NUM_BYTES] ^= 1;
+        expand_bits(&lut, bits, NUM_BYTES, pixels);
+        sink += pixels[i % (NUM_BYTES * 8)].raw_data;
+    }
+    kernel = (now_ns() - start) / ROUNDS;
+
+    // Both ran the same number of rounds, so they end up with the same bits
+    expand_bits_per_pixel(&foreground, &background, bits, NUM_BYTES, reference);
+    if(memcmp(reference, pixels, sizeof(pixels)) != 0) {
+        printf("Kernel output does not match the per pixel loop!\n");
+        return 1;
+    }
+
+    printf("Expand %d pixels: per pixel %.1f ns, kernel %.1f ns (%.1fx)\n",
+           NUM_BYTES * 8, per_pixel, kernel, per_pixel / kernel);
+
+    return 0;
+}
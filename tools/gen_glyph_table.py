@@ -0,0 +1,93 @@
+#!/usr/bin/env python3
+"""Generate pre-scaled glyph bitmaps from the 8x8 font.
+
+Usage: gen_glyph_table.py <font.c> <glyph_table.c>
+
+For every character the UI uses, the glyph is scaled to 1x, 2x and 3x and
+stored as a packed 1 bit per pixel bitmap, in the order the ST7735 expects
+the pixels: x first, then y, least significant bit first. The display is
+rotated, so a font row ends up along x and a font column along y.
+"""
+
+import re
+import sys
+
+FONT_NUM_ROWS = 8
+SCALES = (1, 2, 3)
+DEGREE_MARK = 128
+
+# Characters used by display.c, keep this in sync when adding text to the UI
+CHARACTERS = [ord(c) for c in "0123456789-.%InOutTH"] + [DEGREE_MARK]
+
+
+def read_font(path):
+    with open(path) as f:
+        text = f.read()
+
+    glyphs = []
+    for match in re.finditer(r"\{((?:\s*0x[0-9A-Fa-f]{2}\s*,?){8})\}", text):
+        glyphs.append([int(value, 16) for value in re.findall(r"0x[0-9A-Fa-f]{2}", match.group(1))])
+
+    if len(glyphs) != DEGREE_MARK + 1:
+        sys.exit("expected %d glyphs in %s, found %d" % (DEGREE_MARK + 1, path, len(glyphs)))
+
+    return glyphs
+
+
+def scale_glyph(rows, scale):
+    size = FONT_NUM_ROWS * scale
+    bits = []
+
+    for y in range(size):
+        for x in range(size):
+            bits.append((rows[x // scale] >> (y // scale)) & 1)
+
+    packed = []
+    for i in range(0, len(bits), 8):
+        packed.append(sum(bit << n for n, bit in enumerate(bits[i:i + 8])))
+
+    return packed
+
+
+def char_name(character):
+    if character == DEGREE_MARK:
+        return "degree mark"
+    return "'%s'" % chr(character)
+
+
+def main():
+    if len(sys.argv) != 3:
+        sys.exit(__doc__)
+
+    font = read_font(sys.argv[1])
+    out = []
+
+    out.append("// Generated by tools/gen_glyph_table.py from font.c, do not edit")
+    out.append('#include "glyph_table.h"')
+    out.append("")
+    out.append("")
+    out.append("const int8_t glyph_table_index[FONT_MAX_CHAR] = {")
+    index = [-1] * (DEGREE_MARK + 1)
+    for i, character in enumerate(CHARACTERS):
+        index[character] = i
+    for i in range(0, len(index), 16):
+        out.append("    " + " ".join("%2d," % value for value in index[i:i + 16]))
+    out.append("};")
+
+    for scale in SCALES:
+        out.append("")
+        out.append("const uint8_t glyph_table_scale%d[][GLYPH_TABLE_SIZE(%d)] = {" % (scale, scale))
+        for character in CHARACTERS:
+            packed = scale_glyph(font[character], scale)
+            out.append("    {   // %s" % char_name(character))
+            for i in range(0, len(packed), 12):
+                out.append("        " + " ".join("0x%02X," % value for value in packed[i:i + 12]))
+            out.append("    },")
+        out.append("};")
+
+    with open(sys.argv[2], "w") as f:
+        f.write("\n".join(out) + "\n")
+
+
+if __name__ == "__main__":
+    main()